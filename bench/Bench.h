@@ -0,0 +1,38 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Минимальный каркас бенчмарков без внешних зависимостей.
+// Функция бенчмарка выполняет iterations операций и возвращает контрольную
+// сумму, чтобы компилятор не выбросил работу.
+using BenchFunction = uint64_t (*)(uint64_t iterations);
+
+struct BenchCase {
+    std::string name;
+    BenchFunction function;
+};
+
+std::vector<BenchCase>& benchRegistry();
+
+// Замер без смысла (не выполнено условие бенчмарка): сообщение попадает в отчёт,
+// а FlappyBird_bench завершается с кодом 1
+void benchFail(const std::string& message);
+// Дополнительная величина замера (например, пиксели на кадр) для отчёта;
+// повторный вызов с тем же именем заменяет значение
+void benchCounter(const std::string& name, double value);
+
+struct BenchRegistrar {
+    BenchRegistrar(const char* name, BenchFunction function) {
+        benchRegistry().push_back(BenchCase{name, function});
+    }
+};
+
+#define BENCH_CONCAT_INNER(a, b) a##b
+#define BENCH_CONCAT(a, b) BENCH_CONCAT_INNER(a, b)
+#define BENCHMARK(name, function) \
+    static BenchRegistrar BENCH_CONCAT(benchRegistrar, __LINE__)(name, function)
+
+#endif // BENCH_H
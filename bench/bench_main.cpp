@@ -0,0 +1,149 @@
+#include "Bench.h"
+#include <SDL.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <utility>
+
+std::vector<BenchCase>& benchRegistry() {
+    static std::vector<BenchCase> registry;
+    return registry;
+}
+
+struct BenchResult {
+    std::string name;
+    uint64_t iterations;
+    double nsPerOp;
+    double opsPerSecond;
+    uint64_t checksum;
+    std::string failure;
+    std::vector<std::pair<std::string, double>> counters;
+};
+
+// Ошибка текущего бенчмарка; при нескольких вызовах остаётся первая
+static std::string currentFailure;
+static std::vector<std::pair<std::string, double>> currentCounters;
+
+void benchFail(const std::string& message) {
+    if (currentFailure.empty()) {
+        currentFailure = message;
+    }
+}
+
+void benchCounter(const std::string& name, double value) {
+    for (auto& counter : currentCounters) {
+        if (counter.first == name) {
+            counter.second = value;
+            return;
+        }
+    }
+    currentCounters.emplace_back(name, value);
+}
+
+static double runOnce(BenchFunction function, uint64_t iterations, uint64_t& checksum) {
+    auto start = std::chrono::steady_clock::now();
+    checksum ^= function(iterations);
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Подбор числа итераций до minSeconds, затем медиана по нескольким повторам
+static BenchResult runBench(const BenchCase& bench, double minSeconds, int repetitions) {
+    currentFailure.clear();
+    currentCounters.clear();
+    uint64_t checksum = 0;
+    uint64_t iterations = 1;
+    while (runOnce(bench.function, iterations, checksum) < minSeconds && iterations < (1ull << 40)) {
+        iterations *= 2;
+    }
+
+    std::vector<double> samples;
+    for (int i = 0; i < repetitions; i++) {
+        samples.push_back(runOnce(bench.function, iterations, checksum) * 1e9 / iterations);
+    }
+    std::sort(samples.begin(), samples.end());
+    const double median = samples[samples.size() / 2];
+    return BenchResult{bench.name, iterations, median, 1e9 / median, checksum, currentFailure, currentCounters};
+}
+
+static std::string toJson(const std::vector<BenchResult>& results) {
+    std::ostringstream out;
+    out << "{\n  \"benchmarks\": [\n";
+    for (size_t i = 0; i < results.size(); i++) {
+        const BenchResult& r = results[i];
+        char line[512];
+        snprintf(line, sizeof(line),
+                 "    {\"name\": \"%s\", \"iterations\": %llu, \"ns_per_op\": %.3f, \"ops_per_sec\": %.1f",
+                 r.name.c_str(), static_cast<unsigned long long>(r.iterations), r.nsPerOp, r.opsPerSecond);
+        out << line;
+        for (const auto& counter : r.counters) {
+            snprintf(line, sizeof(line), ", \"%s\": %.1f", counter.first.c_str(), counter.second);
+            out << line;
+        }
+        if (!r.failure.empty()) {
+            out << ", \"failed\": \"" << r.failure << "\"";
+        }
+        out << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+    return out.str();
+}
+
+int main(int argc, char* argv[]) {
+    const char* filter = nullptr;
+    const char* outPath = nullptr;
+    double minSeconds = 0.2;
+    int repetitions = 5;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            filter = argv[++i];
+        }
+        else if (strcmp(argv[i], "--out") == 0 && i + 1 < argc) {
+            outPath = argv[++i];
+        }
+        else if (strcmp(argv[i], "--min-time") == 0 && i + 1 < argc) {
+            minSeconds = atof(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--repetitions") == 0 && i + 1 < argc) {
+            repetitions = std::max(1, atoi(argv[++i]));
+        }
+        else if (strcmp(argv[i], "--list") == 0) {
+            for (const auto& bench : benchRegistry()) {
+                std::cout << bench.name << std::endl;
+            }
+            return 0;
+        }
+    }
+
+    std::vector<BenchResult> results;
+    bool failed = false;
+    for (const auto& bench : benchRegistry()) {
+        if (filter && bench.name.find(filter) == std::string::npos) {
+            continue;
+        }
+        BenchResult result = runBench(bench, minSeconds, repetitions);
+        std::cerr << result.name << ": " << result.nsPerOp << " ns/op";
+        for (const auto& counter : result.counters) {
+            std::cerr << ", " << counter.first << " " << counter.second;
+        }
+        std::cerr << std::endl;
+        if (!result.failure.empty()) {
+            std::cerr << result.name << " FAILED: " << result.failure << std::endl;
+            failed = true;
+        }
+        results.push_back(result);
+    }
+
+    const std::string json = toJson(results);
+    if (outPath) {
+        std::ofstream out(outPath);
+        out << json;
+    } else {
+        std::cout << json;
+    }
+    return failed ? 1 : 0;
+}
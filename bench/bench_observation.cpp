@@ -0,0 +1,81 @@
+#include "Bench.h"
+#include "Autopilot.h"
+#include "ObservationRasterizer.h"
+#include <vector>
+
+// Кадры наблюдений 84x84, как у агентов Atari. Состояния заранее записаны
+// с автопилотом, чтобы замер не включал шаг симуляции
+static const int FRAME_SIZE = 84;
+static const size_t STATE_COUNT = 4096;
+static const int STACK_DEPTH = 4;
+
+static const std::vector<Simulation>& recordedStates() {
+    static std::vector<Simulation> states;
+    if (states.empty()) {
+        Simulation sim;
+        states.reserve(STATE_COUNT);
+        while (states.size() < STATE_COUNT) {
+            sim.step(autopilot(sim));
+            states.push_back(sim);
+        }
+    }
+    return states;
+}
+
+static uint64_t runRender(ObservationRasterizer::Kernel kernel, uint64_t iterations) {
+    const std::vector<Simulation>& states = recordedStates();
+    ObservationRasterizer rasterizer(FRAME_SIZE, FRAME_SIZE);
+    rasterizer.setKernel(kernel);
+    std::vector<uint8_t> frame(rasterizer.frameBytes());
+    uint64_t checksum = 0;
+    for (uint64_t i = 0; i < iterations; i++) {
+        rasterizer.render(states[i % STATE_COUNT], frame.data());
+        checksum += frame[i % frame.size()];
+    }
+    return checksum;
+}
+
+static uint64_t benchRenderScalar(uint64_t iterations) {
+    return runRender(ObservationRasterizer::KERNEL_SCALAR, iterations);
+}
+BENCHMARK("observation/render_84x84_scalar", benchRenderScalar);
+
+static uint64_t benchRenderSse2(uint64_t iterations) {
+    return runRender(ObservationRasterizer::KERNEL_SSE2, iterations);
+}
+BENCHMARK("observation/render_84x84_sse2", benchRenderSse2);
+
+static uint64_t benchRenderAvx2(uint64_t iterations) {
+    return runRender(ObservationRasterizer::KERNEL_AVX2, iterations);
+}
+BENCHMARK("observation/render_84x84_avx2", benchRenderAvx2);
+
+// Стопка из STACK_DEPTH кадров: сдвиг старых кадров и новый кадр, как в сервере сред
+static uint64_t benchRenderStacked(uint64_t iterations) {
+    const std::vector<Simulation>& states = recordedStates();
+    ObservationRasterizer rasterizer(FRAME_SIZE, FRAME_SIZE);
+    std::vector<uint8_t> stack(rasterizer.frameBytes() * STACK_DEPTH);
+    rasterizer.renderStacked(states[0], nullptr, stack.data(), STACK_DEPTH);
+    uint64_t checksum = 0;
+    for (uint64_t i = 0; i < iterations; i++) {
+        rasterizer.renderStacked(states[i % STATE_COUNT], stack.data(), stack.data(), STACK_DEPTH);
+        checksum += stack[i % stack.size()];
+    }
+    return checksum;
+}
+BENCHMARK("observation/render_84x84_stack4", benchRenderStacked);
+
+// Шаг симуляции вместе с кадром — стоимость одного наблюдения в сервере сред
+static uint64_t benchStepAndRender(uint64_t iterations) {
+    Simulation sim;
+    ObservationRasterizer rasterizer(FRAME_SIZE, FRAME_SIZE);
+    std::vector<uint8_t> frame(rasterizer.frameBytes());
+    uint64_t checksum = 0;
+    for (uint64_t i = 0; i < iterations; i++) {
+        checksum += sim.step(autopilot(sim));
+        rasterizer.render(sim, frame.data());
+        checksum += frame[i % frame.size()];
+    }
+    return checksum;
+}
+BENCHMARK("observation/step_and_render_84x84", benchStepAndRender);
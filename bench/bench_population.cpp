@@ -0,0 +1,49 @@
+#include "Bench.h"
+#include "BirdPopulation.h"
+#include <vector>
+
+// Одна итерация — шаг популяции из POPULATION птиц. Птицы машут, опустившись
+// ниже своей целевой высоты, поэтому часть из них живёт долго, а часть
+// разбивается о трубы; при вымирании половины популяция перезапускается.
+static const size_t POPULATION = 4096;
+
+static uint64_t runPopulation(BirdPopulation::Kernel kernel, uint64_t iterations) {
+    BirdPopulation population(POPULATION, 1);
+    population.setKernel(kernel);
+
+    std::vector<int32_t> targets(POPULATION);
+    for (size_t i = 0; i < POPULATION; i++) {
+        targets[i] = 200 + static_cast<int32_t>(i % 160);
+    }
+    std::vector<uint8_t> flaps(POPULATION);
+
+    uint64_t checksum = 0;
+    for (uint64_t i = 0; i < iterations; i++) {
+        const int32_t* y = population.y();
+        for (size_t b = 0; b < POPULATION; b++) {
+            flaps[b] = y[b] > targets[b];
+        }
+        population.step(flaps.data());
+
+        if ((i & 63) == 63 && population.aliveCount() < POPULATION / 2) {
+            checksum += population.score()[0];
+            population.reset(i);
+        }
+    }
+    return checksum + population.aliveCount();
+}
+
+static uint64_t benchPopulationScalar(uint64_t iterations) {
+    return runPopulation(BirdPopulation::KERNEL_SCALAR, iterations);
+}
+BENCHMARK("population/step_4096_scalar", benchPopulationScalar);
+
+static uint64_t benchPopulationSse2(uint64_t iterations) {
+    return runPopulation(BirdPopulation::KERNEL_SSE2, iterations);
+}
+BENCHMARK("population/step_4096_sse2", benchPopulationSse2);
+
+static uint64_t benchPopulationAvx2(uint64_t iterations) {
+    return runPopulation(BirdPopulation::KERNEL_AVX2, iterations);
+}
+BENCHMARK("population/step_4096_avx2", benchPopulationAvx2);
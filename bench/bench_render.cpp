@@ -0,0 +1,211 @@
+#include "Bench.h"
+#include "Autopilot.h"
+#include "Game.h"
+#include "TextCache.h"
+#include "Replay.h"
+#include <algorithm>
+#include <climits>
+#include <string>
+
+// Рендеринг через SDL без GPU: dummy-драйверы видео/звука и программный рендерер.
+// Окружение создаётся один раз на весь процесс.
+struct RenderFixture {
+    Game game;
+    bool ready;
+
+    RenderFixture() : ready(false) {
+        SDL_SetHint(SDL_HINT_VIDEODRIVER, "dummy");
+        SDL_SetHint(SDL_HINT_AUDIODRIVER, "dummy");
+        SDL_SetHint(SDL_HINT_RENDER_DRIVER, "software");
+        ready = game.init();
+        if (!ready) {
+            std::cerr << "Render benchmarks: Game::init failed" << std::endl;
+        }
+    }
+
+    static RenderFixture& instance() {
+        static RenderFixture fixture;
+        return fixture;
+    }
+
+    // Нажатие пробела через очередь событий SDL, как от игрока
+    void pressSpace() {
+        SDL_Event event = {};
+        event.type = SDL_KEYDOWN;
+        event.key.keysym.sym = SDLK_SPACE;
+        SDL_PushEvent(&event);
+        game.handleEvents();
+    }
+};
+
+static uint64_t benchFrameWaiting(uint64_t iterations) {
+    RenderFixture& fixture = RenderFixture::instance();
+    if (!fixture.ready) {
+        return 0;
+    }
+    while (fixture.game.getSimulation().getState() != Simulation::WAITING) {
+        fixture.pressSpace();
+        fixture.game.update();
+    }
+    // Без update() кадр не меняется, и программный рендерер перерисовал бы пустую
+    // область; полная перерисовка сохраняет смысл замера — целый кадр
+    for (uint64_t i = 0; i < iterations; i++) {
+        fixture.game.requestRedraw();
+        fixture.game.render();
+    }
+    return fixture.game.getRenderStats().drawCalls;
+}
+BENCHMARK("render/frame_waiting", benchFrameWaiting);
+
+// Шаг симуляции + кадр во время игры под автопилотом. В отчёт идёт среднее
+// число перерисованных пикселей на кадр игры (полный кадр — 800x600)
+static uint64_t benchFramePlaying(uint64_t iterations) {
+    RenderFixture& fixture = RenderFixture::instance();
+    if (!fixture.ready) {
+        return 0;
+    }
+    uint64_t checksum = 0;
+    uint64_t playingFrames = 0;
+    uint64_t repaintedPixels = 0;
+    for (uint64_t i = 0; i < iterations; i++) {
+        if (autopilot(fixture.game.getSimulation()).flap) {
+            fixture.pressSpace();
+        }
+        fixture.game.update();
+        if (!fixture.game.render()) {
+            continue;
+        }
+        const RenderStats& stats = fixture.game.getRenderStats();
+        checksum += stats.sprites;
+        if (fixture.game.getSimulation().getState() == Simulation::PLAYING) {
+            playingFrames++;
+            repaintedPixels += stats.repaintedPixels;
+        }
+    }
+    if (playingFrames > 0) {
+        benchCounter("repainted_px_per_frame", static_cast<double>(repaintedPixels) / playingFrames);
+    }
+    return checksum;
+}
+BENCHMARK("render/frame_playing", benchFramePlaying);
+
+static TTF_Font* benchFont() {
+    static TTF_Font* font = TTF_OpenFont("assets/font.ttf", 28);
+    return font;
+}
+
+// Прежний путь: растеризация и загрузка текстуры на каждый вызов
+static uint64_t benchTextUncached(uint64_t iterations) {
+    RenderFixture& fixture = RenderFixture::instance();
+    SDL_Renderer* renderer = fixture.game.getRenderer();
+    TTF_Font* font = benchFont();
+    if (!fixture.ready || !renderer || !font) {
+        return 0;
+    }
+    uint64_t checksum = 0;
+    for (uint64_t i = 0; i < iterations; i++) {
+        SDL_Surface* surface = TTF_RenderText_Blended(font, "Score: 42", SDL_Color{255, 223, 0, 255});
+        SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
+        SDL_Rect rect = {20, 20, surface->w, surface->h};
+        SDL_RenderCopy(renderer, texture, nullptr, &rect);
+        checksum += surface->w;
+        SDL_FreeSurface(surface);
+        SDL_DestroyTexture(texture);
+    }
+    return checksum;
+}
+BENCHMARK("text/render_uncached", benchTextUncached);
+
+static uint64_t benchTextCached(uint64_t iterations) {
+    RenderFixture& fixture = RenderFixture::instance();
+    SDL_Renderer* renderer = fixture.game.getRenderer();
+    TTF_Font* font = benchFont();
+    if (!fixture.ready || !renderer || !font) {
+        return 0;
+    }
+    TextCache cache;
+    cache.init(renderer, font);
+    const std::string text = "Score: 42";
+    uint64_t checksum = 0;
+    for (uint64_t i = 0; i < iterations; i++) {
+        const TextCache::Entry* entry = cache.get(text.c_str(), SDL_Color{255, 223, 0, 255});
+        if (!entry) {
+            return checksum;
+        }
+        SDL_Rect rect = {20, 20, entry->w, entry->h};
+        SDL_RenderCopy(renderer, entry->texture, nullptr, &rect);
+        checksum += entry->w;
+    }
+    return checksum;
+}
+BENCHMARK("text/render_cached", benchTextCached);
+
+// Призраки замера: у каждого свой seed и своя трасса, автопилот без ошибок
+// держится на ней все GHOST_RACE_TICKS шагов, так что в замере живы все призраки
+static const size_t GHOST_COUNT = 5000;
+static const uint64_t GHOST_RACE_TICKS = 60 * Simulation::TICKS_PER_SECOND;
+
+static const std::vector<Replay>& ghostReplays() {
+    static std::vector<Replay> replays;
+    for (uint64_t seed = 1; replays.size() < GHOST_COUNT; seed++) {
+        Simulation sim(seed);
+        ReplayRecorder recorder;
+        recorder.begin(seed, Simulation::TICKS_PER_SECOND);
+        uint64_t raceEnd = 0;
+        while (sim.getState() != Simulation::GAME_OVER && (raceEnd == 0 || sim.getTick() < raceEnd)) {
+            const Simulation::Input input = autopilot(sim);
+            sim.step(input);
+            recorder.recordStep(sim, input);
+            if (raceEnd == 0 && sim.getState() == Simulation::PLAYING) {
+                raceEnd = sim.getTick() + GHOST_RACE_TICKS;
+            }
+        }
+        // Трасса, на которой автопилот разбился, дала бы призрака, пропадающего в замере
+        if (sim.getState() == Simulation::GAME_OVER) {
+            continue;
+        }
+        recorder.finish(sim);
+        replays.push_back(recorder.getReplay());
+    }
+    return replays;
+}
+
+// Кадр игры с 5000 призраками в одном вызове SDL_RenderGeometry. Каждый призрак
+// должен быть в каждом кадре, иначе замер ничего не говорит о 5000 призраках
+static uint64_t benchFrameGhosts(uint64_t iterations) {
+    RenderFixture& fixture = RenderFixture::instance();
+    if (!fixture.ready) {
+        return 0;
+    }
+    for (const Replay& replay : ghostReplays()) {
+        fixture.game.addGhost(replay);
+    }
+    while (fixture.game.getSimulation().getState() != Simulation::WAITING) {
+        fixture.pressSpace();
+        fixture.game.update();
+    }
+    // Заезд начинается с первым взмахом игрока, до замера
+    fixture.pressSpace();
+    fixture.game.update();
+
+    uint64_t checksum = 0;
+    int minSprites = INT_MAX;
+    for (uint64_t i = 0; i < iterations; i++) {
+        if (autopilot(fixture.game.getSimulation()).flap) {
+            fixture.pressSpace();
+        }
+        fixture.game.update();
+        fixture.game.render();
+        const int sprites = fixture.game.getRenderStats().sprites;
+        minSprites = std::min(minSprites, sprites);
+        checksum += sprites;
+    }
+    const size_t ghostCount = fixture.game.getGhostCount();
+    fixture.game.clearGhosts();
+    if (iterations > 0 && static_cast<size_t>(minSprites) < ghostCount) {
+        benchFail("only " + std::to_string(minSprites) + " sprites in a frame with " +
+                  std::to_string(ghostCount) + " ghosts");
+    }
+    return checksum;
+}
+BENCHMARK("render/frame_ghosts_5000", benchFrameGhosts);
@@ -0,0 +1,59 @@
+#include "Bench.h"
+#include "Random.h"
+#include "ScoreStore.h"
+#include <filesystem>
+#include <vector>
+
+static const uint64_t STORE_RECORDS = 1000000;
+
+// Таблица на миллион забегов во временном каталоге, общая для всех замеров
+static ScoreStore& benchStore() {
+    static ScoreStore store;
+    if (!store.isOpen()) {
+        const std::filesystem::path log = std::filesystem::temp_directory_path() / "flappy_bench_scores.log";
+        std::filesystem::remove(log);
+        std::filesystem::remove(std::filesystem::path(log).replace_extension(".idx"));
+        store.open(log.string());
+
+        Random random(7);
+        std::vector<ScoreStore::Record> records(STORE_RECORDS);
+        for (auto& record : records) {
+            record = ScoreStore::Record{static_cast<int32_t>(random.bounded(200)), 30000, random.next(),
+                                        1700000000, store.getCabinet()};
+        }
+        store.append(records.data(), records.size());
+    }
+    return store;
+}
+
+// "Лучше X% забегов" на экране конца игры
+static uint64_t benchFractionBelow(uint64_t iterations) {
+    const ScoreStore& store = benchStore();
+    double sum = 0;
+    for (uint64_t i = 0; i < iterations; i++) {
+        sum += store.fractionBelow(static_cast<int>(i % 250));
+    }
+    return static_cast<uint64_t>(sum);
+}
+BENCHMARK("scores/fraction_below_1m", benchFractionBelow);
+
+static uint64_t benchTop10(uint64_t iterations) {
+    const ScoreStore& store = benchStore();
+    ScoreStore::Record top[10];
+    uint64_t checksum = 0;
+    for (uint64_t i = 0; i < iterations; i++) {
+        checksum += store.top(top, 10) + top[0].score;
+    }
+    return checksum;
+}
+BENCHMARK("scores/top10_1m", benchTop10);
+
+// Дозапись одного забега: журнал и обновление индекса
+static uint64_t benchAppend(uint64_t iterations) {
+    ScoreStore& store = benchStore();
+    for (uint64_t i = 0; i < iterations; i++) {
+        store.append(ScoreStore::Record{static_cast<int32_t>(i % 200), 30000, i, 1700000000, store.getCabinet()});
+    }
+    return store.size();
+}
+BENCHMARK("scores/append", benchAppend);
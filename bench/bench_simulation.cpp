@@ -0,0 +1,64 @@
+#include "Bench.h"
+#include "Autopilot.h"
+#include "Collision.h"
+#include "Simulation.h"
+
+// Полный шаг симуляции в режиме игры: физика, движение/появление труб, коллизии
+static uint64_t benchStepPlaying(uint64_t iterations) {
+    Simulation sim;
+    uint64_t checksum = 0;
+    for (uint64_t i = 0; i < iterations; i++) {
+        checksum += sim.step(autopilot(sim));
+    }
+    return checksum + sim.getScore();
+}
+BENCHMARK("simulation/step_autopilot", benchStepPlaying);
+
+// Появление и удаление пары труб в кольцевом буфере
+static uint64_t benchPipeSpawnRetire(uint64_t iterations) {
+    Simulation::PipeRing ring;
+    uint64_t checksum = 0;
+    for (uint64_t i = 0; i < iterations; i++) {
+        ring.push_back(Simulation::Pipe{static_cast<int>(i), 100, Simulation::PIPE_GAP, false});
+        if (ring.size() > 4) {
+            checksum += ring.front().x;
+            ring.pop_front();
+        }
+    }
+    return checksum;
+}
+BENCHMARK("simulation/pipe_spawn_retire", benchPipeSpawnRetire);
+
+static Simulation::PipeRing makeFullRing() {
+    Simulation::PipeRing ring;
+    for (size_t i = 0; i < Simulation::PipeRing::capacity(); i++) {
+        ring.push_back(Simulation::Pipe{static_cast<int>(i) * 120, 150, Simulation::PIPE_GAP, false});
+    }
+    return ring;
+}
+
+// Проверка птицы против полностью заполненного кольца труб
+static uint64_t benchBirdVsPipes(uint64_t iterations) {
+    const Simulation::PipeRing ring = makeFullRing();
+    uint64_t hits = 0;
+    for (uint64_t i = 0; i < iterations; i++) {
+        const int y = 100 + static_cast<int>(i % 300);
+        const Simulation::Rect prev = {200, y, Simulation::BIRD_WIDTH, Simulation::BIRD_HEIGHT};
+        const Simulation::Rect cur = {200, y + 3, Simulation::BIRD_WIDTH, Simulation::BIRD_HEIGHT};
+        hits += Collision::birdHitsPipes(prev, cur, ring, Simulation::PIPE_SPEED);
+    }
+    return hits;
+}
+BENCHMARK("collision/bird_vs_pipes", benchBirdVsPipes);
+
+static uint64_t benchSweep(uint64_t iterations) {
+    const Simulation::Rect obstacle = {300, 0, Simulation::PIPE_WIDTH, 200};
+    uint64_t hits = 0;
+    float t;
+    for (uint64_t i = 0; i < iterations; i++) {
+        const Simulation::Rect bird = {240 + static_cast<int>(i % 128), static_cast<int>(i % 400), 40, 30};
+        hits += Collision::sweep(bird, 2.0f, 4.0f, obstacle, t);
+    }
+    return hits;
+}
+BENCHMARK("collision/sweep", benchSweep);
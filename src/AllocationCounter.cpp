@@ -0,0 +1,117 @@
+#include "AllocationCounter.h"
+#include <SDL.h>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+std::atomic<uint64_t> allocationCount(0);
+std::atomic<uint64_t> freeCount(0);
+std::atomic<uint64_t> allocatedBytes(0);
+
+#ifdef FLAPPY_COUNT_ALLOCATIONS
+inline void countAllocation(size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+}
+
+inline void countFree(void* pointer) {
+    if (pointer) {
+        freeCount.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+SDL_malloc_func sdlMalloc = nullptr;
+SDL_calloc_func sdlCalloc = nullptr;
+SDL_realloc_func sdlRealloc = nullptr;
+SDL_free_func sdlFree = nullptr;
+
+void* SDLCALL countingMalloc(size_t size) {
+    countAllocation(size);
+    return sdlMalloc(size);
+}
+
+void* SDLCALL countingCalloc(size_t count, size_t size) {
+    countAllocation(count * size);
+    return sdlCalloc(count, size);
+}
+
+// realloc может переносить блок, поэтому считается выделением
+void* SDLCALL countingRealloc(void* pointer, size_t size) {
+    countAllocation(size);
+    return sdlRealloc(pointer, size);
+}
+
+void SDLCALL countingFree(void* pointer) {
+    countFree(pointer);
+    sdlFree(pointer);
+}
+#endif
+
+} // namespace
+
+#ifdef FLAPPY_COUNT_ALLOCATIONS
+// Замена глобальных new/delete; nothrow-версии стандартной библиотеки вызывают их же.
+// Варианты с выравниванием (align_val_t) не подменяются и не считаются
+void* operator new(size_t size) {
+    countAllocation(size);
+    if (void* pointer = std::malloc(size ? size : 1)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void* pointer) noexcept {
+    countFree(pointer);
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer) noexcept {
+    operator delete(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept {
+    operator delete(pointer);
+}
+
+void operator delete[](void* pointer, size_t) noexcept {
+    operator delete(pointer);
+}
+#endif
+
+namespace AllocationCounter {
+
+bool isEnabled() {
+#ifdef FLAPPY_COUNT_ALLOCATIONS
+    return true;
+#else
+    return false;
+#endif
+}
+
+Counts get() {
+    Counts counts;
+    counts.allocations = allocationCount.load(std::memory_order_relaxed);
+    counts.frees = freeCount.load(std::memory_order_relaxed);
+    counts.bytes = allocatedBytes.load(std::memory_order_relaxed);
+    return counts;
+}
+
+bool hookSdl() {
+#ifdef FLAPPY_COUNT_ALLOCATIONS
+    if (sdlMalloc) {
+        return true;
+    }
+    SDL_GetMemoryFunctions(&sdlMalloc, &sdlCalloc, &sdlRealloc, &sdlFree);
+    return SDL_SetMemoryFunctions(countingMalloc, countingCalloc, countingRealloc, countingFree) == 0;
+#else
+    return false;
+#endif
+}
+
+} // namespace AllocationCounter
@@ -0,0 +1,27 @@
+#ifndef ALLOCATION_COUNTER_H
+#define ALLOCATION_COUNTER_H
+
+#include <cstdint>
+
+// Отладочный счётчик выделений памяти во всех потоках: глобальные new/delete
+// и аллокатор SDL (им пользуются SDL_image, SDL_ttf и SDL_mixer).
+// Работает только в сборке с -DFLAPPY_COUNT_ALLOCATIONS=ON; иначе счётчики нулевые.
+// malloc внутри сторонних библиотек (libpng, FreeType) не виден.
+namespace AllocationCounter {
+
+struct Counts {
+    uint64_t allocations = 0;   // new, SDL_malloc/calloc/realloc
+    uint64_t frees = 0;
+    uint64_t bytes = 0;
+};
+
+bool isEnabled();
+// Накопленные значения с запуска; кадр — разность двух снимков
+Counts get();
+// Подменяет функции памяти SDL на считающие обёртки.
+// Вызывается до первого обращения к SDL
+bool hookSdl();
+
+} // namespace AllocationCounter
+
+#endif // ALLOCATION_COUNTER_H
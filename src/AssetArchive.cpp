@@ -0,0 +1,216 @@
+#include "AssetArchive.h"
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+const size_t HEADER_SIZE = 16;
+const size_t ENTRY_SIZE = 64;
+
+void putBytes(std::vector<unsigned char>& out, uint64_t value, int count) {
+    for (int i = 0; i < count; i++) {
+        out.push_back(static_cast<unsigned char>(value >> (8 * i)));
+    }
+}
+
+uint64_t getBytes(const unsigned char* data, int count) {
+    uint64_t value = 0;
+    for (int i = 0; i < count; i++) {
+        value |= static_cast<uint64_t>(data[i]) << (8 * i);
+    }
+    return value;
+}
+
+} // namespace
+
+AssetArchive::AssetArchive() :
+    mapping(nullptr),
+    mappedSize(0),
+    fileHandle(nullptr),
+    mappingHandle(nullptr)
+{
+}
+
+AssetArchive::~AssetArchive() {
+    close();
+}
+
+bool AssetArchive::open(const std::string& path) {
+    close();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    LARGE_INTEGER fileSize;
+    HANDLE view = nullptr;
+    if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0) {
+        view = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    }
+    if (!view) {
+        CloseHandle(file);
+        return false;
+    }
+    mapping = static_cast<const unsigned char*>(MapViewOfFile(view, FILE_MAP_READ, 0, 0, 0));
+    if (!mapping) {
+        CloseHandle(view);
+        CloseHandle(file);
+        return false;
+    }
+    fileHandle = file;
+    mappingHandle = view;
+    mappedSize = static_cast<size_t>(fileSize.QuadPart);
+#else
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size <= 0) {
+        ::close(fd);
+        return false;
+    }
+    void* view = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (view == MAP_FAILED) {
+        return false;
+    }
+    mapping = static_cast<const unsigned char*>(view);
+    mappedSize = static_cast<size_t>(info.st_size);
+#endif
+
+    // Заголовок и индекс
+    if (mappedSize < HEADER_SIZE || memcmp(mapping, "FBPK", 4) != 0 || getBytes(mapping + 4, 2) != VERSION) {
+        std::cout << "Asset archive " << path << " has an unsupported format" << std::endl;
+        close();
+        return false;
+    }
+    const uint64_t count = getBytes(mapping + 8, 4);
+    if (count > (mappedSize - HEADER_SIZE) / ENTRY_SIZE) {
+        std::cout << "Asset archive " << path << " is truncated" << std::endl;
+        close();
+        return false;
+    }
+
+    entries.reserve(count);
+    for (uint64_t i = 0; i < count; i++) {
+        const unsigned char* record = mapping + HEADER_SIZE + i * ENTRY_SIZE;
+        Entry entry;
+        entry.name.assign(reinterpret_cast<const char*>(record), strnlen(reinterpret_cast<const char*>(record), NAME_SIZE));
+        entry.type = static_cast<Type>(getBytes(record + 32, 4));
+        entry.format = static_cast<uint32_t>(getBytes(record + 36, 4));
+        entry.width = static_cast<int32_t>(getBytes(record + 40, 4));
+        entry.height = static_cast<int32_t>(getBytes(record + 44, 4));
+        const uint64_t offset = getBytes(record + 48, 8);
+        const uint64_t size = getBytes(record + 56, 8);
+        if (offset > mappedSize || size > mappedSize - offset) {
+            std::cout << "Asset archive " << path << ": entry " << entry.name << " is out of bounds" << std::endl;
+            close();
+            return false;
+        }
+        entry.data = mapping + offset;
+        entry.size = static_cast<size_t>(size);
+        entries.push_back(entry);
+    }
+    return true;
+}
+
+void AssetArchive::close() {
+    entries.clear();
+    if (!mapping) {
+        return;
+    }
+#ifdef _WIN32
+    UnmapViewOfFile(mapping);
+    CloseHandle(static_cast<HANDLE>(mappingHandle));
+    CloseHandle(static_cast<HANDLE>(fileHandle));
+    mappingHandle = nullptr;
+    fileHandle = nullptr;
+#else
+    munmap(const_cast<unsigned char*>(mapping), mappedSize);
+#endif
+    mapping = nullptr;
+    mappedSize = 0;
+}
+
+const AssetArchive::Entry* AssetArchive::find(const std::string& name) const {
+    for (const auto& entry : entries) {
+        if (entry.name == name) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+void AssetArchiveWriter::addImage(const std::string& name, uint32_t format, int width, int height,
+                                  const void* pixels, int pitch, int bytesPerPixel) {
+    Pending entry{name, AssetArchive::TYPE_IMAGE, format, width, height, {}};
+    const size_t rowSize = static_cast<size_t>(width) * bytesPerPixel;
+    entry.data.resize(rowSize * height);
+    for (int y = 0; y < height; y++) {
+        memcpy(entry.data.data() + y * rowSize, static_cast<const unsigned char*>(pixels) + y * pitch, rowSize);
+    }
+    pending.push_back(std::move(entry));
+}
+
+void AssetArchiveWriter::addSound(const std::string& name, uint32_t format, int frequency, int channels,
+                                  const void* samples, size_t size) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(samples);
+    pending.push_back(Pending{name, AssetArchive::TYPE_SOUND, format, frequency, channels,
+                              std::vector<unsigned char>(bytes, bytes + size)});
+}
+
+void AssetArchiveWriter::addBlob(const std::string& name, const void* data, size_t size) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    pending.push_back(Pending{name, AssetArchive::TYPE_BLOB, 0, 0, 0,
+                              std::vector<unsigned char>(bytes, bytes + size)});
+}
+
+bool AssetArchiveWriter::save(const std::string& path) const {
+    std::vector<unsigned char> out;
+    out.insert(out.end(), {'F', 'B', 'P', 'K'});
+    putBytes(out, AssetArchive::VERSION, 2);
+    putBytes(out, 0, 2);
+    putBytes(out, pending.size(), 4);
+    putBytes(out, 0, 4);
+
+    // Данные идут сразу за индексом, каждый блок выровнен для SIMD-копирования
+    uint64_t offset = HEADER_SIZE + ENTRY_SIZE * pending.size();
+    for (const auto& entry : pending) {
+        offset = (offset + AssetArchive::DATA_ALIGNMENT - 1) & ~static_cast<uint64_t>(AssetArchive::DATA_ALIGNMENT - 1);
+        char name[AssetArchive::NAME_SIZE] = {};
+        strncpy(name, entry.name.c_str(), sizeof(name) - 1);
+        out.insert(out.end(), name, name + sizeof(name));
+        putBytes(out, entry.type, 4);
+        putBytes(out, entry.format, 4);
+        putBytes(out, static_cast<uint32_t>(entry.width), 4);
+        putBytes(out, static_cast<uint32_t>(entry.height), 4);
+        putBytes(out, offset, 8);
+        putBytes(out, entry.data.size(), 8);
+        offset += entry.data.size();
+    }
+    for (const auto& entry : pending) {
+        out.resize((out.size() + AssetArchive::DATA_ALIGNMENT - 1) & ~(AssetArchive::DATA_ALIGNMENT - 1), 0);
+        out.insert(out.end(), entry.data.begin(), entry.data.end());
+    }
+
+    std::ofstream file(path, std::ios::binary);
+    if (!file.write(reinterpret_cast<const char*>(out.data()), out.size())) {
+        std::cout << "Failed to write asset archive " << path << std::endl;
+        return false;
+    }
+    return true;
+}
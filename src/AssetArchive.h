@@ -0,0 +1,78 @@
+#ifndef ASSET_ARCHIVE_H
+#define ASSET_ARCHIVE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Архив ресурсов (формат FBPK v1): заголовок, индекс и выровненные блоки данных.
+// Картинки хранятся готовыми пикселями, звуки — PCM в формате микшера,
+// шрифт и музыка — исходными байтами. Архив отображается в память целиком,
+// поэтому данные записей действительны, пока архив открыт.
+class AssetArchive {
+public:
+    static const uint16_t VERSION = 1;
+    static const size_t NAME_SIZE = 32;
+    static const size_t DATA_ALIGNMENT = 16;
+
+    enum Type : uint32_t {
+        TYPE_IMAGE,     // format — SDL_PixelFormatEnum, строки без выравнивания
+        TYPE_SOUND,     // format — SDL_AudioFormat
+        TYPE_BLOB
+    };
+
+    struct Entry {
+        std::string name;
+        Type type;
+        uint32_t format;
+        int32_t width;      // Для звука — частота
+        int32_t height;     // Для звука — число каналов
+        const unsigned char* data;
+        size_t size;
+    };
+
+    AssetArchive();
+    ~AssetArchive();
+
+    AssetArchive(const AssetArchive&) = delete;
+    AssetArchive& operator=(const AssetArchive&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const { return mapping != nullptr; }
+
+    const Entry* find(const std::string& name) const;
+    size_t getMappedSize() const { return mappedSize; }
+
+private:
+    const unsigned char* mapping;
+    size_t mappedSize;
+    void* fileHandle;
+    void* mappingHandle;
+    std::vector<Entry> entries;
+};
+
+// Сборка архива упаковщиком
+class AssetArchiveWriter {
+public:
+    void addImage(const std::string& name, uint32_t format, int width, int height,
+                  const void* pixels, int pitch, int bytesPerPixel);
+    void addSound(const std::string& name, uint32_t format, int frequency, int channels,
+                  const void* samples, size_t size);
+    void addBlob(const std::string& name, const void* data, size_t size);
+    bool save(const std::string& path) const;
+
+private:
+    struct Pending {
+        std::string name;
+        AssetArchive::Type type;
+        uint32_t format;
+        int32_t width;
+        int32_t height;
+        std::vector<unsigned char> data;
+    };
+    std::vector<Pending> pending;
+};
+
+#endif // ASSET_ARCHIVE_H
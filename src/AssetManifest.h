@@ -0,0 +1,68 @@
+#ifndef ASSET_MANIFEST_H
+#define ASSET_MANIFEST_H
+
+#include <SDL.h>
+#include "Simulation.h"
+
+// Список ресурсов игры. Общий для Game и упаковщика, чтобы архив
+// содержал спрайты ровно того размера и звук ровно того формата,
+// которые нужны во время выполнения.
+namespace AssetManifest {
+
+struct Sprite {
+    const char* name;
+    const char* path;
+    int maxWidth;   // Размер с запасом под экранный; крупнее уменьшается при упаковке
+    int maxHeight;
+};
+
+struct Sound {
+    const char* name;
+    const char* path;
+};
+
+enum SpriteId {
+    SPRITE_BIRD,
+    SPRITE_BACKGROUND,
+    SPRITE_PIPE,
+    SPRITE_GROUND,
+    SPRITE_COUNT
+};
+
+inline constexpr Sprite SPRITES[SPRITE_COUNT] = {
+    {"bird", "bird.png", Simulation::BIRD_WIDTH * 2, Simulation::BIRD_HEIGHT * 2},
+    {"background", "background.png", Simulation::SCREEN_WIDTH, Simulation::SCREEN_HEIGHT},
+    {"pipe", "pipe.png", Simulation::PIPE_WIDTH * 2, Simulation::SCREEN_HEIGHT},
+    {"ground", "ground.png", Simulation::SCREEN_WIDTH, Simulation::GROUND_HEIGHT}
+};
+
+// Индекс звука в банке совпадает с номером его канала микшера
+enum SoundId {
+    SOUND_HIT,
+    SOUND_DIE,
+    SOUND_SCORE,
+    SOUND_JUMP,
+    SOUND_COUNT
+};
+
+inline constexpr Sound SOUNDS[SOUND_COUNT] = {
+    {"hit", "audio/hit.wav"},
+    {"die", "audio/die.wav"},
+    {"score", "audio/score.wav"},
+    {"jump", "audio/jump.wav"}
+};
+
+inline constexpr const char* FONT_PATH = "font.ttf";
+inline constexpr const char* MUSIC_PATH = "audio/background.mp3";
+
+// Формат микшера; звуки в архиве заранее приведены к нему
+inline constexpr int AUDIO_FREQUENCY = 44100;
+inline constexpr Uint16 AUDIO_SAMPLE_FORMAT = AUDIO_S16SYS;
+inline constexpr int AUDIO_CHANNELS = 2;
+
+// Формат пикселей атласа
+inline constexpr Uint32 PIXEL_FORMAT = SDL_PIXELFORMAT_ARGB8888;
+
+} // namespace AssetManifest
+
+#endif // ASSET_MANIFEST_H
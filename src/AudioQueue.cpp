@@ -0,0 +1,116 @@
+#include "AudioQueue.h"
+#include "Profiler.h"
+#include <iostream>
+
+AudioQueue::AudioQueue() :
+    stopping(false),
+    wake(nullptr),
+    dropped(0)
+{
+    bank.fill(nullptr);
+}
+
+AudioQueue::~AudioQueue() {
+    stop();
+}
+
+bool AudioQueue::start() {
+    if (isRunning()) {
+        return true;
+    }
+    wake = SDL_CreateSemaphore(0);
+    if (!wake) {
+        std::cout << "Failed to create audio queue semaphore: " << SDL_GetError() << std::endl;
+        return false;
+    }
+    stopping = false;
+    thread = std::thread(&AudioQueue::run, this);
+    return true;
+}
+
+void AudioQueue::stop() {
+    if (thread.joinable()) {
+        stopping = true;
+        SDL_SemPost(wake);
+        thread.join();
+    }
+    if (wake) {
+        SDL_DestroySemaphore(wake);
+        wake = nullptr;
+    }
+}
+
+void AudioQueue::play(AssetManifest::SoundId sound, uint32_t delayMs) {
+    if (!bank[sound]) {
+        return;
+    }
+    push(Event{COMMAND_PLAY, sound, Profiler::nowUs() + delayMs * 1000ULL});
+}
+
+void AudioQueue::haltAll() {
+    push(Event{COMMAND_HALT_ALL, AssetManifest::SOUND_COUNT, Profiler::nowUs()});
+}
+
+void AudioQueue::push(const Event& event) {
+    if (!isRunning() || !queue.push(event)) {
+        dropped++;
+        return;
+    }
+    SDL_SemPost(wake);
+}
+
+void AudioQueue::run() {
+    // Ожидающие события упорядочены по времени; при равном времени — по порядку поступления
+    std::array<Event, MAX_PENDING> pending;
+    size_t pendingCount = 0;
+
+    while (!stopping) {
+        Event event;
+        while (queue.pop(event)) {
+            // Остановка отменяет и звуки, отложенные до неё: иначе звук смерти
+            // прошлого забега прозвучал бы в новом
+            if (event.command == COMMAND_HALT_ALL) {
+                pendingCount = 0;
+                execute(event);
+                continue;
+            }
+            // Переполнение: событие теряется, а не звучит раньше своего времени
+            if (pendingCount == MAX_PENDING) {
+                dropped++;
+                continue;
+            }
+            size_t i = pendingCount++;
+            for (; i > 0 && pending[i - 1].dueUs > event.dueUs; i--) {
+                pending[i] = pending[i - 1];
+            }
+            pending[i] = event;
+        }
+
+        const uint64_t now = Profiler::nowUs();
+        size_t due = 0;
+        while (due < pendingCount && pending[due].dueUs <= now) {
+            execute(pending[due++]);
+        }
+        for (size_t i = due; i < pendingCount; i++) {
+            pending[i - due] = pending[i];
+        }
+        pendingCount -= due;
+
+        Uint32 timeoutMs = SDL_MUTEX_MAXWAIT;
+        if (pendingCount > 0) {
+            timeoutMs = static_cast<Uint32>((pending[0].dueUs - now + 999) / 1000);
+        }
+        SDL_SemWaitTimeout(wake, timeoutMs);
+    }
+}
+
+void AudioQueue::execute(const Event& event) {
+    switch (event.command) {
+        case COMMAND_PLAY:
+            Mix_PlayChannel(event.sound, bank[event.sound], 0);
+            break;
+        case COMMAND_HALT_ALL:
+            Mix_HaltChannel(-1);
+            break;
+    }
+}
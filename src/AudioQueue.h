@@ -0,0 +1,68 @@
+#ifndef AUDIO_QUEUE_H
+#define AUDIO_QUEUE_H
+
+#include <SDL.h>
+#include <SDL_mixer.h>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include "AssetManifest.h"
+#include "SpscQueue.h"
+
+// Банк звуков по индексу AssetManifest::SoundId и очередь звуковых событий
+// со временем срабатывания. Игровой поток только кладёт событие в очередь
+// без блокировок; вызовы SDL_mixer и ожидание задержек выполняет отдельный
+// аудиопоток, поэтому отложенные звуки не тормозят симуляцию и рендеринг.
+class AudioQueue {
+public:
+    static const size_t CAPACITY = 64;
+    static const size_t MAX_PENDING = 32;
+
+    enum Command : uint8_t {
+        COMMAND_PLAY,
+        COMMAND_HALT_ALL
+    };
+
+    struct Event {
+        Command command;
+        AssetManifest::SoundId sound;
+        uint64_t dueUs;
+    };
+
+    AudioQueue();
+    ~AudioQueue();
+
+    AudioQueue(const AudioQueue&) = delete;
+    AudioQueue& operator=(const AudioQueue&) = delete;
+
+    // Банк заполняется до start(); владение звуками остаётся у вызывающего
+    void setSound(AssetManifest::SoundId sound, Mix_Chunk* chunk) { bank[sound] = chunk; }
+    Mix_Chunk* getSound(AssetManifest::SoundId sound) const { return bank[sound]; }
+
+    bool start();
+    // Останавливает аудиопоток; невыполненные события отбрасываются
+    void stop();
+    bool isRunning() const { return thread.joinable(); }
+
+    // Только из игрового потока. Канал звука — его индекс в банке
+    void play(AssetManifest::SoundId sound, uint32_t delayMs = 0);
+    // Останавливает все каналы и отменяет ещё не прозвучавшие отложенные звуки
+    void haltAll();
+    // События, потерянные из-за переполнения очереди или списка отложенных
+    uint64_t droppedEvents() const { return dropped; }
+
+private:
+    std::array<Mix_Chunk*, AssetManifest::SOUND_COUNT> bank;
+    SpscQueue<Event, CAPACITY> queue;
+    std::thread thread;
+    std::atomic<bool> stopping;
+    SDL_sem* wake;
+    std::atomic<uint64_t> dropped;
+
+    void push(const Event& event);
+    void run();
+    void execute(const Event& event);
+};
+
+#endif // AUDIO_QUEUE_H
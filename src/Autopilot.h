@@ -0,0 +1,27 @@
+#ifndef AUTOPILOT_H
+#define AUTOPILOT_H
+
+#include "Simulation.h"
+
+// Простой автопилот: держит птицу у центра ближайшего зазора,
+// после проигрыша сразу начинает заново
+inline Simulation::Input autopilot(const Simulation& sim) {
+    Simulation::Input input;
+    if (sim.getState() == Simulation::GAME_OVER) {
+        input.flap = true;
+        return input;
+    }
+
+    const Simulation::Rect& bird = sim.getBird();
+    int target = Simulation::SCREEN_HEIGHT / 2;
+    for (const auto& pipe : sim.getPipes()) {
+        if (pipe.x + Simulation::PIPE_WIDTH >= bird.x) {
+            target = pipe.gapTop + pipe.gapHeight / 2;
+            break;
+        }
+    }
+    input.flap = bird.y + bird.h / 2 > target && sim.getBirdVelocity() >= 0;
+    return input;
+}
+
+#endif // AUTOPILOT_H
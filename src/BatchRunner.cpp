@@ -0,0 +1,65 @@
+#include "BatchRunner.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+namespace {
+
+struct EpisodeResult {
+    int score;
+    uint64_t ticks;
+};
+
+// Эпизод начинается в WAITING и заканчивается первым GAME_OVER
+EpisodeResult runEpisode(uint64_t seed, uint64_t maxTicks, const Policy& policy) {
+    Simulation sim(seed);
+    uint64_t ticks = 0;
+    while (ticks < maxTicks && sim.getState() != Simulation::GAME_OVER) {
+        sim.step(policy(sim));
+        ticks++;
+    }
+    return EpisodeResult{sim.getScore(), ticks};
+}
+
+} // namespace
+
+BatchResult runBatch(const BatchConfig& config, const Policy& policy) {
+    std::vector<EpisodeResult> episodes(config.episodes);
+    const uint64_t chunk = std::max<uint64_t>(1, config.episodesPerTask);
+
+    auto start = std::chrono::steady_clock::now();
+    ThreadPool pool(config.threads);
+    for (uint64_t first = 0; first < config.episodes; first += chunk) {
+        const uint64_t last = std::min(config.episodes, first + chunk);
+        pool.submit([&, first, last] {
+            for (uint64_t i = first; i < last; i++) {
+                episodes[i] = runEpisode(config.seed + i, config.maxTicksPerEpisode, policy);
+            }
+        });
+    }
+    pool.wait();
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    BatchResult result;
+    result.episodes = config.episodes;
+    result.threads = pool.size();
+    result.seconds = seconds;
+    if (episodes.empty()) {
+        return result;
+    }
+
+    long long totalScore = 0;
+    result.minScore = episodes[0].score;
+    result.maxScore = episodes[0].score;
+    for (const auto& episode : episodes) {
+        totalScore += episode.score;
+        result.totalTicks += episode.ticks;
+        result.minScore = std::min(result.minScore, episode.score);
+        result.maxScore = std::max(result.maxScore, episode.score);
+    }
+    result.meanScore = static_cast<double>(totalScore) / episodes.size();
+    result.episodesPerSecond = episodes.size() / std::max(seconds, 1e-9);
+    result.ticksPerSecond = result.totalTicks / std::max(seconds, 1e-9);
+    return result;
+}
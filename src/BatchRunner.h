@@ -0,0 +1,35 @@
+#ifndef BATCH_RUNNER_H
+#define BATCH_RUNNER_H
+
+#include "Simulation.h"
+#include <cstdint>
+#include <functional>
+
+// Пакетный прогон независимых эпизодов на всех ядрах, без SDL.
+// Агент подключается как политика: состояние мира -> ввод на этот тик.
+// Политика вызывается из нескольких потоков одновременно.
+using Policy = std::function<Simulation::Input(const Simulation&)>;
+
+struct BatchConfig {
+    uint64_t episodes = 1000;
+    unsigned threads = 0;                 // 0 — по числу ядер
+    uint64_t seed = 1;                    // эпизод i играет с seed + i
+    uint64_t maxTicksPerEpisode = 100000; // ограничение для "бессмертных" агентов
+    uint64_t episodesPerTask = 16;
+};
+
+struct BatchResult {
+    uint64_t episodes = 0;
+    uint64_t totalTicks = 0;
+    double meanScore = 0.0;
+    int minScore = 0;
+    int maxScore = 0;
+    double seconds = 0.0;
+    double episodesPerSecond = 0.0;
+    double ticksPerSecond = 0.0;
+    unsigned threads = 0;
+};
+
+BatchResult runBatch(const BatchConfig& config, const Policy& policy);
+
+#endif // BATCH_RUNNER_H
@@ -0,0 +1,313 @@
+#include "BirdPopulation.h"
+#include "Collision.h"
+#include <algorithm>
+#include <cstring>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define BIRD_POPULATION_X86 1
+#endif
+
+namespace {
+
+using StepParams = BirdPopulation::StepParams;
+
+// Скалярное ядро; оно же обрабатывает хвост массива после SIMD-ядер
+void stepScalar(const StepParams& p, size_t begin, size_t end, const uint8_t* flaps,
+                int32_t* y, float* v, float* angle, int32_t* alive, int32_t* score) {
+    for (size_t i = begin; i < end; i++) {
+        if (!alive[i]) {
+            continue;
+        }
+        if (flaps[i]) {
+            v[i] = p.jumpVelocity;
+            angle[i] = -25.0f;
+        }
+
+        const int32_t prevY = y[i];
+        float velocity = std::min(v[i] + p.gravity, p.maxFallSpeed);
+        int32_t newY = prevY + static_cast<int32_t>(velocity);
+        angle[i] = velocity < 0 ? -25.0f : std::min(angle[i] + 1.0f, 70.0f);
+
+        if (newY < 0) {
+            newY = 0;
+            velocity = 0;
+        }
+        v[i] = velocity;
+        if (newY > p.groundY) {
+            y[i] = p.groundY;
+            alive[i] = 0;
+            continue;
+        }
+        y[i] = newY;
+        score[i] += p.passed;
+
+        const float startY = static_cast<float>(prevY);
+        const float dy = static_cast<float>(newY - prevY);
+        for (int c = 0; c < p.candidates; c++) {
+            const float y0 = startY + dy * p.t0[c];
+            const float y1 = startY + dy * p.t1[c];
+            if (std::min(y0, y1) < p.gapTop[c] || std::max(y0, y1) > p.gapBottom[c]) {
+                alive[i] = 0;
+                break;
+            }
+        }
+    }
+}
+
+#ifdef BIRD_POPULATION_X86
+
+__attribute__((target("sse2")))
+size_t stepSse2(const StepParams& p, size_t count, const uint8_t* flaps,
+                int32_t* y, float* v, float* angle, int32_t* alive, int32_t* score) {
+    const __m128 gravity = _mm_set1_ps(p.gravity);
+    const __m128 jump = _mm_set1_ps(p.jumpVelocity);
+    const __m128 maxFall = _mm_set1_ps(p.maxFallSpeed);
+    const __m128 upAngle = _mm_set1_ps(-25.0f);
+    const __m128 maxAngle = _mm_set1_ps(70.0f);
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 zeroF = _mm_setzero_ps();
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i groundY = _mm_set1_epi32(p.groundY);
+    const __m128i passed = _mm_set1_epi32(p.passed);
+
+    auto blendF = [](__m128 a, __m128 b, __m128 mask) {
+        return _mm_or_ps(_mm_andnot_ps(mask, a), _mm_and_ps(mask, b));
+    };
+    auto blendI = [](__m128i a, __m128i b, __m128i mask) {
+        return _mm_or_si128(_mm_andnot_si128(mask, a), _mm_and_si128(mask, b));
+    };
+
+    const size_t end = count & ~static_cast<size_t>(3);
+    for (size_t i = 0; i < end; i += 4) {
+        const __m128i aliveMask = _mm_load_si128(reinterpret_cast<const __m128i*>(alive + i));
+        if (_mm_movemask_epi8(aliveMask) == 0) {
+            continue;
+        }
+
+        int32_t flapBytes;
+        memcpy(&flapBytes, flaps + i, sizeof(flapBytes));
+        __m128i flap = _mm_cvtsi32_si128(flapBytes);
+        flap = _mm_unpacklo_epi16(_mm_unpacklo_epi8(flap, zero), zero);
+        const __m128 flapMask = _mm_castsi128_ps(_mm_andnot_si128(_mm_cmpeq_epi32(flap, zero), aliveMask));
+
+        __m128 velocity = blendF(_mm_load_ps(v + i), jump, flapMask);
+        __m128 birdAngle = blendF(_mm_load_ps(angle + i), upAngle, flapMask);
+        const __m128i prevY = _mm_load_si128(reinterpret_cast<const __m128i*>(y + i));
+
+        velocity = _mm_min_ps(_mm_add_ps(velocity, gravity), maxFall);
+        __m128i newY = _mm_add_epi32(prevY, _mm_cvttps_epi32(velocity));
+        birdAngle = blendF(_mm_min_ps(_mm_add_ps(birdAngle, one), maxAngle), upAngle,
+                           _mm_cmplt_ps(velocity, zeroF));
+
+        const __m128i top = _mm_cmplt_epi32(newY, zero);
+        newY = blendI(newY, zero, top);
+        velocity = blendF(velocity, zeroF, _mm_castsi128_ps(top));
+
+        const __m128i ground = _mm_cmpgt_epi32(newY, groundY);
+        newY = blendI(newY, groundY, ground);
+        __m128i newAlive = _mm_andnot_si128(ground, aliveMask);
+
+        __m128i birdScore = _mm_load_si128(reinterpret_cast<const __m128i*>(score + i));
+        birdScore = _mm_add_epi32(birdScore, _mm_and_si128(passed, newAlive));
+
+        const __m128 startY = _mm_cvtepi32_ps(prevY);
+        const __m128 dy = _mm_cvtepi32_ps(_mm_sub_epi32(newY, prevY));
+        for (int c = 0; c < p.candidates; c++) {
+            const __m128 y0 = _mm_add_ps(startY, _mm_mul_ps(dy, _mm_set1_ps(p.t0[c])));
+            const __m128 y1 = _mm_add_ps(startY, _mm_mul_ps(dy, _mm_set1_ps(p.t1[c])));
+            const __m128 hit = _mm_or_ps(_mm_cmplt_ps(_mm_min_ps(y0, y1), _mm_set1_ps(p.gapTop[c])),
+                                         _mm_cmpgt_ps(_mm_max_ps(y0, y1), _mm_set1_ps(p.gapBottom[c])));
+            newAlive = _mm_andnot_si128(_mm_castps_si128(hit), newAlive);
+        }
+
+        // Разбившиеся раньше птицы не меняются
+        const __m128 aliveF = _mm_castsi128_ps(aliveMask);
+        _mm_store_ps(v + i, blendF(_mm_load_ps(v + i), velocity, aliveF));
+        _mm_store_ps(angle + i, blendF(_mm_load_ps(angle + i), birdAngle, aliveF));
+        _mm_store_si128(reinterpret_cast<__m128i*>(y + i), blendI(prevY, newY, aliveMask));
+        _mm_store_si128(reinterpret_cast<__m128i*>(score + i), birdScore);
+        _mm_store_si128(reinterpret_cast<__m128i*>(alive + i), newAlive);
+    }
+    return end;
+}
+
+__attribute__((target("avx2")))
+size_t stepAvx2(const StepParams& p, size_t count, const uint8_t* flaps,
+                int32_t* y, float* v, float* angle, int32_t* alive, int32_t* score) {
+    const __m256 gravity = _mm256_set1_ps(p.gravity);
+    const __m256 jump = _mm256_set1_ps(p.jumpVelocity);
+    const __m256 maxFall = _mm256_set1_ps(p.maxFallSpeed);
+    const __m256 upAngle = _mm256_set1_ps(-25.0f);
+    const __m256 maxAngle = _mm256_set1_ps(70.0f);
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 zeroF = _mm256_setzero_ps();
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i groundY = _mm256_set1_epi32(p.groundY);
+    const __m256i passed = _mm256_set1_epi32(p.passed);
+
+    const size_t end = count & ~static_cast<size_t>(7);
+    for (size_t i = 0; i < end; i += 8) {
+        const __m256i aliveMask = _mm256_load_si256(reinterpret_cast<const __m256i*>(alive + i));
+        if (_mm256_testz_si256(aliveMask, aliveMask)) {
+            continue;
+        }
+
+        const __m256i flap = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(flaps + i)));
+        const __m256 flapMask = _mm256_castsi256_ps(_mm256_andnot_si256(_mm256_cmpeq_epi32(flap, zero), aliveMask));
+
+        __m256 velocity = _mm256_blendv_ps(_mm256_load_ps(v + i), jump, flapMask);
+        __m256 birdAngle = _mm256_blendv_ps(_mm256_load_ps(angle + i), upAngle, flapMask);
+        const __m256i prevY = _mm256_load_si256(reinterpret_cast<const __m256i*>(y + i));
+
+        velocity = _mm256_min_ps(_mm256_add_ps(velocity, gravity), maxFall);
+        __m256i newY = _mm256_add_epi32(prevY, _mm256_cvttps_epi32(velocity));
+        birdAngle = _mm256_blendv_ps(_mm256_min_ps(_mm256_add_ps(birdAngle, one), maxAngle), upAngle,
+                                     _mm256_cmp_ps(velocity, zeroF, _CMP_LT_OQ));
+
+        const __m256i top = _mm256_cmpgt_epi32(zero, newY);
+        newY = _mm256_blendv_epi8(newY, zero, top);
+        velocity = _mm256_blendv_ps(velocity, zeroF, _mm256_castsi256_ps(top));
+
+        const __m256i ground = _mm256_cmpgt_epi32(newY, groundY);
+        newY = _mm256_blendv_epi8(newY, groundY, ground);
+        __m256i newAlive = _mm256_andnot_si256(ground, aliveMask);
+
+        __m256i birdScore = _mm256_load_si256(reinterpret_cast<const __m256i*>(score + i));
+        birdScore = _mm256_add_epi32(birdScore, _mm256_and_si256(passed, newAlive));
+
+        const __m256 startY = _mm256_cvtepi32_ps(prevY);
+        const __m256 dy = _mm256_cvtepi32_ps(_mm256_sub_epi32(newY, prevY));
+        for (int c = 0; c < p.candidates; c++) {
+            const __m256 y0 = _mm256_add_ps(startY, _mm256_mul_ps(dy, _mm256_set1_ps(p.t0[c])));
+            const __m256 y1 = _mm256_add_ps(startY, _mm256_mul_ps(dy, _mm256_set1_ps(p.t1[c])));
+            const __m256 hit = _mm256_or_ps(
+                _mm256_cmp_ps(_mm256_min_ps(y0, y1), _mm256_set1_ps(p.gapTop[c]), _CMP_LT_OQ),
+                _mm256_cmp_ps(_mm256_max_ps(y0, y1), _mm256_set1_ps(p.gapBottom[c]), _CMP_GT_OQ));
+            newAlive = _mm256_andnot_si256(_mm256_castps_si256(hit), newAlive);
+        }
+
+        // Разбившиеся раньше птицы не меняются
+        const __m256 aliveF = _mm256_castsi256_ps(aliveMask);
+        _mm256_store_ps(v + i, _mm256_blendv_ps(_mm256_load_ps(v + i), velocity, aliveF));
+        _mm256_store_ps(angle + i, _mm256_blendv_ps(_mm256_load_ps(angle + i), birdAngle, aliveF));
+        _mm256_store_si256(reinterpret_cast<__m256i*>(y + i), _mm256_blendv_epi8(prevY, newY, aliveMask));
+        _mm256_store_si256(reinterpret_cast<__m256i*>(score + i), birdScore);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(alive + i), newAlive);
+    }
+    return end;
+}
+
+#endif // BIRD_POPULATION_X86
+
+} // namespace
+
+BirdPopulation::BirdPopulation(size_t count, uint64_t seed) :
+    count(count),
+    kernel(bestKernel()),
+    tick(0),
+    birdY(count),
+    birdVelocity(count),
+    birdAngle(count),
+    birdAlive(count),
+    birdScore(count),
+    noFlaps(count, 0)
+{
+    reset(seed);
+}
+
+void BirdPopulation::reset(uint64_t seed) {
+    course.random.reseed(seed);
+    course.clear();
+    tick = 0;
+    std::fill(birdY.begin(), birdY.end(), Simulation::SCREEN_HEIGHT / 2);
+    std::fill(birdVelocity.begin(), birdVelocity.end(), 0.0f);
+    std::fill(birdAngle.begin(), birdAngle.end(), 0.0f);
+    std::fill(birdAlive.begin(), birdAlive.end(), -1);
+    std::fill(birdScore.begin(), birdScore.end(), 0);
+}
+
+BirdPopulation::Kernel BirdPopulation::bestKernel() {
+#ifdef BIRD_POPULATION_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return KERNEL_AVX2;
+    }
+    if (__builtin_cpu_supports("sse2")) {
+        return KERNEL_SSE2;
+    }
+#endif
+    return KERNEL_SCALAR;
+}
+
+const char* BirdPopulation::kernelName(Kernel kernel) {
+    switch (kernel) {
+        case KERNEL_AVX2: return "avx2";
+        case KERNEL_SSE2: return "sse2";
+        default: return "scalar";
+    }
+}
+
+void BirdPopulation::setKernel(Kernel value) {
+    kernel = std::min(value, bestKernel());
+}
+
+size_t BirdPopulation::aliveCount() const {
+    size_t alive = 0;
+    for (size_t i = 0; i < count; i++) {
+        alive += birdAlive[i] != 0;
+    }
+    return alive;
+}
+
+void BirdPopulation::step(const uint8_t* flaps) {
+    if (!flaps) {
+        flaps = noFlaps.data();
+    }
+    tick++;
+
+    const int birdX = Simulation::SCREEN_WIDTH / 4;
+    StepParams params;
+    params.gravity = Simulation::INITIAL_GRAVITY;
+    params.jumpVelocity = std::max(Simulation::INITIAL_JUMP_FORCE, -4.0f);
+    params.maxFallSpeed = Simulation::MAX_FALL_SPEED;
+    params.groundY = Simulation::SCREEN_HEIGHT - Simulation::GROUND_HEIGHT - Simulation::BIRD_HEIGHT;
+    params.passed = course.advance(birdX);
+    params.candidates = 0;
+
+    // Трубы, попадающие в колонку птиц, общие для всей популяции. Как и в
+    // Collision::sweep, в системе отсчёта труб птица за тик смещается вправо на PIPE_SPEED
+    const float dx = static_cast<float>(Simulation::PIPE_SPEED);
+    const float startX = static_cast<float>(birdX - Simulation::PIPE_SPEED);
+    const int maxX = birdX + Simulation::BIRD_WIDTH;
+    const Simulation::PipeRing& pipes = course.pipes;
+    for (size_t i = Collision::firstPipeRightOf(pipes, birdX - Simulation::PIPE_SPEED);
+         i < pipes.size() && pipes[i].x < maxX && params.candidates < StepParams::MAX_CANDIDATES; i++) {
+        const float enter = (pipes[i].x - Simulation::BIRD_WIDTH - startX) / dx;
+        const float exit = (pipes[i].x + Simulation::PIPE_WIDTH - startX) / dx;
+        const float t0 = std::max(enter, 0.0f);
+        const float t1 = std::min(exit, 1.0f);
+        if (t0 >= t1) {
+            continue;
+        }
+        const int c = params.candidates++;
+        params.t0[c] = t0;
+        params.t1[c] = t1;
+        params.gapTop[c] = static_cast<float>(pipes[i].gapTop);
+        params.gapBottom[c] = static_cast<float>(pipes[i].gapTop + pipes[i].gapHeight - Simulation::BIRD_HEIGHT);
+    }
+
+    size_t done = 0;
+#ifdef BIRD_POPULATION_X86
+    if (kernel == KERNEL_AVX2) {
+        done = stepAvx2(params, count, flaps, birdY.data(), birdVelocity.data(), birdAngle.data(),
+                        birdAlive.data(), birdScore.data());
+    }
+    else if (kernel == KERNEL_SSE2) {
+        done = stepSse2(params, count, flaps, birdY.data(), birdVelocity.data(), birdAngle.data(),
+                        birdAlive.data(), birdScore.data());
+    }
+#endif
+    stepScalar(params, done, count, flaps, birdY.data(), birdVelocity.data(), birdAngle.data(),
+               birdAlive.data(), birdScore.data());
+}
@@ -0,0 +1,75 @@
+#ifndef BIRD_POPULATION_H
+#define BIRD_POPULATION_H
+
+#include "AlignedAllocator.h"
+#include "Simulation.h"
+#include <cstdint>
+
+// Популяция птиц на одной общей трассе в виде структуры массивов.
+// Физика и столкновения те же, что в Simulation::step для состояния PLAYING
+// (включая непрерывную проверку), но считаются ядром AVX2/SSE2 по 8/4 птицы
+// за раз. Все птицы стартуют одновременно с высоты SCREEN_HEIGHT / 2.
+class BirdPopulation {
+public:
+    enum Kernel {
+        KERNEL_SCALAR,
+        KERNEL_SSE2,
+        KERNEL_AVX2
+    };
+
+    explicit BirdPopulation(size_t count, uint64_t seed = 0);
+
+    void reset(uint64_t seed);
+    // flaps — по байту на птицу (ненулевой — взмах в этот тик), может быть nullptr
+    void step(const uint8_t* flaps);
+
+    // Лучшее ядро, доступное на этом процессоре
+    static Kernel bestKernel();
+    static const char* kernelName(Kernel kernel);
+    // Ядро, недоступное на процессоре, заменяется лучшим доступным
+    void setKernel(Kernel kernel);
+    Kernel getKernel() const { return kernel; }
+
+    size_t size() const { return count; }
+    size_t aliveCount() const;
+    uint64_t getTick() const { return tick; }
+    const Simulation::PipeRing& getPipes() const { return course.pipes; }
+
+    const int32_t* y() const { return birdY.data(); }
+    const float* velocity() const { return birdVelocity.data(); }
+    const float* angle() const { return birdAngle.data(); }
+    // -1 — жива, 0 — разбилась
+    const int32_t* alive() const { return birdAlive.data(); }
+    const int32_t* score() const { return birdScore.data(); }
+
+    // Параметры шага, общие для всех птиц
+    struct StepParams {
+        static const int MAX_CANDIDATES = 2;
+
+        float gravity;
+        float jumpVelocity;
+        float maxFallSpeed;
+        int32_t groundY;    // Максимальный y, при котором птица ещё не касается земли
+        int32_t passed;     // Сколько пар труб пройдено в этот тик
+        int candidates;     // Пары труб в колонке птицы
+        float t0[MAX_CANDIDATES];
+        float t1[MAX_CANDIDATES];
+        float gapTop[MAX_CANDIDATES];
+        float gapBottom[MAX_CANDIDATES];  // Нижний край зазора минус высота птицы
+    };
+
+private:
+    size_t count;
+    Kernel kernel;
+    uint64_t tick;
+    Simulation::Course course;
+
+    AlignedVector<int32_t> birdY;
+    AlignedVector<float> birdVelocity;
+    AlignedVector<float> birdAngle;
+    AlignedVector<int32_t> birdAlive;
+    AlignedVector<int32_t> birdScore;
+    AlignedVector<uint8_t> noFlaps;
+};
+
+#endif // BIRD_POPULATION_H
@@ -0,0 +1,87 @@
+#include "Collision.h"
+#include <algorithm>
+#include <limits>
+
+namespace Collision {
+
+bool overlaps(const Simulation::Rect& a, const Simulation::Rect& b) {
+    return a.x < b.x + b.w && b.x < a.x + a.w &&
+           a.y < b.y + b.h && b.y < a.y + a.h;
+}
+
+// Интервал t, на котором точка p + d*t лежит строго внутри (lo, hi)
+static bool axisInterval(float p, float d, float lo, float hi, float& enter, float& exit) {
+    if (d == 0.0f) {
+        enter = -std::numeric_limits<float>::infinity();
+        exit = std::numeric_limits<float>::infinity();
+        return p > lo && p < hi;
+    }
+    enter = (lo - p) / d;
+    exit = (hi - p) / d;
+    if (enter > exit) {
+        std::swap(enter, exit);
+    }
+    return true;
+}
+
+bool sweep(const Simulation::Rect& moving, float dx, float dy,
+           const Simulation::Rect& obstacle, float& tHit) {
+    if (moving.w <= 0 || moving.h <= 0 || obstacle.w <= 0 || obstacle.h <= 0) {
+        return false;
+    }
+
+    // Сумма Минковского: движется левый верхний угол moving, препятствие расширено на его размер
+    float enterX, exitX, enterY, exitY;
+    if (!axisInterval(static_cast<float>(moving.x), dx,
+                      static_cast<float>(obstacle.x - moving.w), static_cast<float>(obstacle.x + obstacle.w),
+                      enterX, exitX) ||
+        !axisInterval(static_cast<float>(moving.y), dy,
+                      static_cast<float>(obstacle.y - moving.h), static_cast<float>(obstacle.y + obstacle.h),
+                      enterY, exitY)) {
+        return false;
+    }
+
+    const float enter = std::max(enterX, enterY);
+    const float exit = std::min(exitX, exitY);
+    if (enter >= exit || enter >= 1.0f || exit <= 0.0f) {
+        return false;
+    }
+    tHit = std::max(enter, 0.0f);
+    return true;
+}
+
+size_t firstPipeRightOf(const Simulation::PipeRing& pipes, int minX) {
+    size_t lo = 0;
+    size_t hi = pipes.size();
+    while (lo < hi) {
+        const size_t mid = (lo + hi) / 2;
+        if (pipes[mid].x + Simulation::PIPE_WIDTH <= minX) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+bool birdHitsPipes(const Simulation::Rect& prevBird, const Simulation::Rect& bird,
+                   const Simulation::PipeRing& pipes, int pipeShift) {
+    // В системе отсчёта труб птица смещается вправо на pipeShift
+    const Simulation::Rect start = {bird.x - pipeShift, prevBird.y, bird.w, bird.h};
+    const float dx = static_cast<float>(pipeShift);
+    const float dy = static_cast<float>(bird.y - prevBird.y);
+    const int minX = start.x;
+    const int maxX = bird.x + bird.w;
+
+    // Проверяются только пары, попадающие в колонку, которую заметает птица
+    for (size_t i = firstPipeRightOf(pipes, minX); i < pipes.size() && pipes[i].x < maxX; i++) {
+        float t;
+        if (sweep(start, dx, dy, pipes[i].topRect(), t) ||
+            sweep(start, dx, dy, pipes[i].bottomRect(), t)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace Collision
@@ -0,0 +1,27 @@
+#ifndef COLLISION_H
+#define COLLISION_H
+
+#include "Simulation.h"
+
+// Проверка столкновений птицы с трубами: отбор по x (трубы в кольце
+// отсортированы по возрастанию x) и непрерывная проверка движущегося AABB
+namespace Collision {
+
+// Та же семантика, что у SDL_HasIntersection: касание краями не считается
+bool overlaps(const Simulation::Rect& a, const Simulation::Rect& b);
+
+// Прямоугольник moving смещается на (dx, dy) за шаг, obstacle неподвижен.
+// При пересечении возвращает true и долю шага до первого касания в tHit.
+bool sweep(const Simulation::Rect& moving, float dx, float dy,
+           const Simulation::Rect& obstacle, float& tHit);
+
+// Индекс первой пары труб, правый край которой правее minX
+size_t firstPipeRightOf(const Simulation::PipeRing& pipes, int minX);
+
+// Птица перешла из prevBird в bird, трубы за тот же шаг сдвинулись влево на pipeShift
+bool birdHitsPipes(const Simulation::Rect& prevBird, const Simulation::Rect& bird,
+                   const Simulation::PipeRing& pipes, int pipeShift);
+
+} // namespace Collision
+
+#endif // COLLISION_H
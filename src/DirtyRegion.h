@@ -0,0 +1,165 @@
+#ifndef DIRTY_REGION_H
+#define DIRTY_REGION_H
+
+#include <SDL.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+// Изменившаяся часть кадра для программного рендерера, у которого содержимое
+// кадра сохраняется между present. Подвижные спрайты кадра сравниваются
+// с прошлым кадром; перерисовать нужно их старое и новое место. Слой, который
+// сдвинулся целиком (полоса земли), добавляется своей областью.
+// Всё остальное (неподвижные слои, меню) совпадает с прошлым кадром.
+class DirtyRegion {
+public:
+    struct Sprite {
+        SDL_FRect rect;
+        float angle;
+
+        bool operator==(const Sprite& other) const {
+            return rect.x == other.rect.x && rect.y == other.rect.y && rect.w == other.rect.w &&
+                   rect.h == other.rect.h && angle == other.angle;
+        }
+    };
+
+    // Если области покрывают больше этой доли экрана, один проход по всему кадру дешевле
+    static constexpr float MAX_PARTIAL_SHARE = 0.75f;
+
+    void reserve(size_t sprites) {
+        previous.reserve(sprites);
+        current.reserve(sprites);
+        rects.reserve(sprites * 2 + MAX_AREAS);
+    }
+
+    // Следующий кадр перерисовывается целиком
+    void invalidate() { full = true; }
+
+    // Начало кадра: спрайты прошлого кадра сохраняются для сравнения
+    void begin() {
+        previous.swap(current);
+        current.clear();
+        areaCount = 0;
+    }
+    void add(const SDL_FRect& rect, float angle = 0.0f) { current.push_back(Sprite{rect, angle}); }
+    // Область слоя, изменившаяся в этом кадре целиком
+    void addArea(const SDL_Rect& rect) {
+        if (areaCount < MAX_AREAS) {
+            areas[areaCount++] = rect;
+        }
+        else {
+            full = true;
+        }
+    }
+
+    // Собирает в getRects() непересекающиеся прямоугольники изменений в пределах screen;
+    // каждый рисуется со своим отсечением. false — кадр рисуется целиком.
+    // Пустой список — кадр не изменился
+    bool collect(const SDL_Rect& screen) {
+        const bool partial = !full;
+        full = false;
+        rects.clear();
+        if (!partial) {
+            return false;
+        }
+
+        if (previous.size() == current.size()) {
+            for (size_t i = 0; i < current.size(); i++) {
+                if (previous[i] == current[i]) {
+                    continue;
+                }
+                // Старое и новое место спрайта почти совпадают, их объединение почти ничего не добавляет
+                SDL_Rect rect = pixelBounds(previous[i]);
+                const SDL_Rect next = pixelBounds(current[i]);
+                SDL_UnionRect(&rect, &next, &rect);
+                push(rects, screen, rect);
+            }
+        }
+        else {
+            // Спрайт появился или исчез, и пары по номеру уже не те же спрайты
+            for (const Sprite& sprite : previous) {
+                push(rects, screen, pixelBounds(sprite));
+            }
+            for (const Sprite& sprite : current) {
+                push(rects, screen, pixelBounds(sprite));
+            }
+        }
+        for (int i = 0; i < areaCount; i++) {
+            push(rects, screen, areas[i]);
+        }
+
+        mergeOverlapping(rects);
+        if (pixelCount(rects) > MAX_PARTIAL_SHARE * screen.w * screen.h) {
+            rects.clear();
+            return false;
+        }
+        return true;
+    }
+
+    const std::vector<SDL_Rect>& getRects() const { return rects; }
+
+    static int64_t pixelCount(const std::vector<SDL_Rect>& list) {
+        int64_t pixels = 0;
+        for (const SDL_Rect& rect : list) {
+            pixels += static_cast<int64_t>(rect.w) * rect.h;
+        }
+        return pixels;
+    }
+
+private:
+    static const int MAX_AREAS = 4;
+
+    std::vector<Sprite> previous;
+    std::vector<Sprite> current;
+    SDL_Rect areas[MAX_AREAS];
+    int areaCount = 0;
+    std::vector<SDL_Rect> rects;
+    bool full = true;
+
+    // Целые пиксели, которых может коснуться спрайт, с запасом в пиксель на округление
+    static SDL_Rect pixelBounds(const Sprite& sprite) {
+        float x = sprite.rect.x, y = sprite.rect.y, w = sprite.rect.w, h = sprite.rect.h;
+        if (sprite.angle != 0.0f) {
+            // Повёрнутый прямоугольник целиком лежит в круге по его диагонали
+            const float radius = std::sqrt(w * w + h * h) * 0.5f;
+            x += w * 0.5f - radius;
+            y += h * 0.5f - radius;
+            w = h = radius * 2.0f;
+        }
+        const int left = static_cast<int>(std::floor(x)) - 1;
+        const int top = static_cast<int>(std::floor(y)) - 1;
+        return SDL_Rect{left, top, static_cast<int>(std::ceil(x + w)) + 1 - left,
+                        static_cast<int>(std::ceil(y + h)) + 1 - top};
+    }
+
+    static void push(std::vector<SDL_Rect>& out, const SDL_Rect& screen, const SDL_Rect& rect) {
+        SDL_Rect clipped;
+        if (SDL_IntersectRect(&rect, &screen, &clipped)) {
+            out.push_back(clipped);
+        }
+    }
+
+    // Пересекающиеся прямоугольники сливаются в объединение, пока такие есть:
+    // иначе общая часть рисовалась бы в каждом проходе. Спрайтов в кадре
+    // не больше двух десятков, так что квадратичный перебор дешевле любой структуры
+    static void mergeOverlapping(std::vector<SDL_Rect>& out) {
+        bool merged = true;
+        while (merged) {
+            merged = false;
+            for (size_t i = 0; i < out.size() && !merged; i++) {
+                for (size_t j = i + 1; j < out.size(); j++) {
+                    if (SDL_HasIntersection(&out[i], &out[j])) {
+                        SDL_UnionRect(&out[i], &out[j], &out[i]);
+                        out[j] = out.back();
+                        out.pop_back();
+                        merged = true;
+                        break;
+                    }
+                }
+            }
+        }
+    }
+};
+
+#endif // DIRTY_REGION_H
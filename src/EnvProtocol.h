@@ -0,0 +1,90 @@
+#ifndef ENV_PROTOCOL_H
+#define ENV_PROTOCOL_H
+
+#include <cstdint>
+
+// Протокол сервера среды для обучения (FlappyBird --serve).
+// По локальному сокету ходят только запросы и ответы по 16 байт. Действия и
+// наблюдения лежат в общем файле, отображённом в память сервером и клиентом:
+//
+//   Header | действия: envCount байт | кольцо из slotCount слотов
+//   слот:  SlotHeader | envCount * Observation | envCount * стопка кадров
+//   стопка: frameStack кадров по frameWidth * frameHeight байт, от старого к новому
+//
+// Клиент пишет действия (ненулевой байт — взмах) и отправляет STEP; сервер шагает
+// все среды и пишет результат в слот sequence % slotCount, номер которого
+// приходит в ответе. Предыдущие slotCount - 1 результатов остаются нетронутыми.
+// Все числа в порядке байт машины: клиент и сервер на одном компьютере.
+namespace EnvProtocol {
+
+const uint32_t VERSION = 2;
+const uint32_t SLOT_COUNT = 4;
+const uint32_t ALIGNMENT = 64;      // Выравнивание секций общей памяти
+
+enum Command : uint32_t {
+    COMMAND_RESET = 1,              // Все среды с начала: среда i получает seed + i
+    COMMAND_STEP = 2,
+    COMMAND_CLOSE = 3               // Остановить сервер
+};
+
+enum Status : uint32_t {
+    STATUS_OK = 0,
+    STATUS_ERROR = 1
+};
+
+struct Request {
+    uint32_t command;
+    uint32_t reserved;
+    uint64_t seed;                  // Только для RESET
+};
+
+struct Reply {
+    uint32_t status;
+    uint32_t slot;                  // Слот кольца с результатом
+    uint64_t sequence;              // Номер результата с начала работы сервера
+};
+
+struct Header {
+    char magic[4];                  // "FBEV"
+    uint32_t version;
+    uint32_t envCount;
+    uint32_t slotCount;
+    uint32_t frameWidth;            // 0 — кадры не рисуются
+    uint32_t frameHeight;
+    uint32_t frameStack;            // Кадров в стопке каждой среды
+    uint32_t reserved;
+    uint64_t actionsOffset;
+    uint64_t slotsOffset;
+    uint64_t slotBytes;
+    uint64_t framesOffset;          // Смещение кадров от начала слота
+    uint64_t totalBytes;
+};
+
+struct SlotHeader {
+    uint64_t sequence;
+    uint64_t episodes;              // Завершённых эпизодов во всех средах
+    uint8_t reserved[ALIGNMENT - 16];
+};
+
+// Наблюдение одной среды после шага; координаты в пикселях экрана 800x600
+struct Observation {
+    float birdY;                    // Верх птицы
+    float birdVelocity;             // Положительная — вниз
+    float gapDistance;              // От левого края птицы до правого края ближайшей пары труб
+    float gapTop;                   // Верх зазора ближайшей пары
+    float gapBottom;                // Низ зазора ближайшей пары
+    float reward;                   // +1 за пару труб, -1 за проигрыш
+    int32_t score;
+    uint8_t terminated;             // Птица разбилась; следующий STEP начнёт новый эпизод
+    uint8_t truncated;              // Эпизод упёрся в ограничение длины
+    uint8_t reserved[2];
+};
+
+static_assert(sizeof(Request) == 16 && sizeof(Reply) == 16, "wire messages are 16 bytes");
+static_assert(sizeof(Header) == 72, "header layout");
+static_assert(sizeof(SlotHeader) == ALIGNMENT, "slot header layout");
+static_assert(sizeof(Observation) == 32, "observation layout");
+
+} // namespace EnvProtocol
+
+#endif // ENV_PROTOCOL_H
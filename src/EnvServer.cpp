@@ -0,0 +1,274 @@
+#include "EnvServer.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+namespace {
+
+const float PIPE_REWARD = 1.0f;
+const float DEATH_REWARD = -1.0f;
+
+uint64_t alignUp(uint64_t value) {
+    return (value + EnvProtocol::ALIGNMENT - 1) / EnvProtocol::ALIGNMENT * EnvProtocol::ALIGNMENT;
+}
+
+} // namespace
+
+EnvServer::EnvServer() :
+    stackBytes(0),
+    header(nullptr),
+    sequence(0),
+    episodes(0),
+    reply()
+{
+}
+
+EnvServer::~EnvServer() {
+    stop();
+}
+
+bool EnvServer::start(const EnvServerConfig& serverConfig) {
+    stop();
+    config = serverConfig;
+    const uint32_t maxFrameSize = ObservationRasterizer::MAX_SIZE;
+    if (config.envCount == 0 || config.frameWidth > maxFrameSize || config.frameHeight > maxFrameSize ||
+        (config.frameWidth == 0) != (config.frameHeight == 0) ||
+        config.frameStack == 0 || config.frameStack > MAX_FRAME_STACK) {
+        std::cout << "Invalid environment server configuration" << std::endl;
+        return false;
+    }
+    if (config.sharedMemoryPath.empty()) {
+        config.sharedMemoryPath = config.socketPath + ".shm";
+    }
+
+    // Раскладка общей памяти описана в заголовке, клиент читает её оттуда
+    stackBytes = static_cast<uint64_t>(config.frameWidth) * config.frameHeight * config.frameStack;
+    const uint64_t actionsOffset = alignUp(sizeof(EnvProtocol::Header));
+    const uint64_t slotsOffset = alignUp(actionsOffset + config.envCount);
+    const uint64_t framesOffset = alignUp(sizeof(EnvProtocol::SlotHeader) +
+                                          static_cast<uint64_t>(config.envCount) * sizeof(EnvProtocol::Observation));
+    const uint64_t slotBytes = alignUp(framesOffset + stackBytes * config.envCount);
+    const uint64_t totalBytes = slotsOffset + slotBytes * EnvProtocol::SLOT_COUNT;
+    if (!sharedMemory.create(config.sharedMemoryPath, static_cast<size_t>(totalBytes))) {
+        return false;
+    }
+
+    header = static_cast<EnvProtocol::Header*>(sharedMemory.data());
+    memcpy(header->magic, "FBEV", 4);
+    header->version = EnvProtocol::VERSION;
+    header->envCount = config.envCount;
+    header->slotCount = EnvProtocol::SLOT_COUNT;
+    header->frameWidth = config.frameWidth;
+    header->frameHeight = config.frameHeight;
+    header->frameStack = config.frameStack;
+    header->reserved = 0;
+    header->actionsOffset = actionsOffset;
+    header->slotsOffset = slotsOffset;
+    header->slotBytes = slotBytes;
+    header->framesOffset = framesOffset;
+    header->totalBytes = totalBytes;
+
+    if (config.frameWidth > 0) {
+        rasterizer.reset(new ObservationRasterizer(static_cast<int>(config.frameWidth),
+                                                   static_cast<int>(config.frameHeight)));
+    }
+    envs.assign(config.envCount, Env());
+    if (config.threads != 1 && config.envCount > ENVS_PER_TASK) {
+        pool.reset(new ThreadPool(config.threads));
+    }
+    reset(config.seed);
+
+    if (!listener.listen(config.socketPath)) {
+        stop();
+        return false;
+    }
+    std::cout << "Serving " << config.envCount << " environments on " << config.socketPath
+              << ", observations in " << config.sharedMemoryPath << " (" << totalBytes << " bytes)" << std::endl;
+    return true;
+}
+
+void EnvServer::stop() {
+    listener.close();
+    pool.reset();
+    rasterizer.reset();
+    envs.clear();
+    header = nullptr;
+    sharedMemory.close();
+    sequence = 0;
+    episodes = 0;
+}
+
+bool EnvServer::run() {
+    bool closeRequested = false;
+    while (!closeRequested) {
+        LocalSocket client = listener.accept();
+        if (!client.isValid()) {
+            std::cout << "Failed to accept a client on " << config.socketPath << std::endl;
+            return false;
+        }
+        if (!serveClient(client, closeRequested)) {
+            std::cout << "Client disconnected" << std::endl;
+        }
+    }
+    return true;
+}
+
+bool EnvServer::serveClient(LocalSocket& client, bool& closeRequested) {
+    // Один запрос — один ответ; клиент ждёт ответа перед следующим запросом
+    EnvProtocol::Request request;
+    while (client.receiveAll(&request, sizeof(request))) {
+        EnvProtocol::Reply response = {EnvProtocol::STATUS_OK, 0, 0};
+        switch (request.command) {
+            case EnvProtocol::COMMAND_RESET:
+                response = reset(request.seed);
+                break;
+            case EnvProtocol::COMMAND_STEP:
+                response = step();
+                break;
+            case EnvProtocol::COMMAND_CLOSE:
+                closeRequested = true;
+                break;
+            default:
+                response.status = EnvProtocol::STATUS_ERROR;
+                break;
+        }
+        if (!client.sendAll(&response, sizeof(response))) {
+            return false;
+        }
+        if (closeRequested) {
+            return true;
+        }
+    }
+    return false;
+}
+
+const EnvProtocol::Reply& EnvServer::reset(uint64_t seed) {
+    config.seed = seed;
+    uint8_t* slot = slotData(static_cast<uint32_t>(sequence % EnvProtocol::SLOT_COUNT));
+    for (uint32_t i = 0; i < envs.size(); i++) {
+        envs[i].episode = 0;
+        startEpisode(envs[i], i);
+        observe(envs[i], i, slot, nullptr, 0.0f, false);
+    }
+    publish(slot);
+    return reply;
+}
+
+const EnvProtocol::Reply& EnvServer::step() {
+    uint8_t* slot = slotData(static_cast<uint32_t>(sequence % EnvProtocol::SLOT_COUNT));
+    // Предыдущий результат ещё лежит в соседнем слоте кольца: стопки кадров сдвигаются оттуда
+    const uint8_t* previousSlot = slotData(static_cast<uint32_t>((sequence - 1) % EnvProtocol::SLOT_COUNT));
+    const uint32_t count = static_cast<uint32_t>(envs.size());
+    if (pool) {
+        for (uint32_t first = 0; first < count; first += ENVS_PER_TASK) {
+            const uint32_t last = static_cast<uint32_t>(std::min<uint64_t>(count, first + ENVS_PER_TASK));
+            pool->submit([this, first, last, slot, previousSlot] { stepRange(first, last, slot, previousSlot); });
+        }
+        pool->wait();
+    }
+    else {
+        stepRange(0, count, slot, previousSlot);
+    }
+    publish(slot);
+    return reply;
+}
+
+void EnvServer::startEpisode(Env& env, uint32_t index) {
+    // Среда index в эпизоде k играет с seed + index + k * envCount: трассы всех
+    // эпизодов различны и не зависят от разбиения на потоки
+    env.sim.seed(config.seed + index + env.episode * envs.size());
+    Simulation::Input flap;
+    flap.flap = true;
+    env.sim.step(flap);
+    env.episode++;
+    env.ticks = 0;
+    env.done = false;
+}
+
+void EnvServer::stepRange(uint32_t first, uint32_t last, uint8_t* slot, const uint8_t* previousSlot) {
+    const uint8_t* actions = getActions();
+    uint64_t finished = 0;
+    for (uint32_t i = first; i < last; i++) {
+        Env& env = envs[i];
+        const bool restarted = env.done;
+        if (restarted) {
+            startEpisode(env, i);
+        }
+        const int scoreBefore = env.sim.getScore();
+        Simulation::Input input;
+        input.flap = actions[i] != 0;
+        env.sim.step(input);
+        env.ticks++;
+
+        const bool terminated = env.sim.getState() == Simulation::GAME_OVER;
+        const bool truncated = !terminated && env.ticks >= config.maxTicksPerEpisode;
+        const float reward = (env.sim.getScore() - scoreBefore) * PIPE_REWARD + (terminated ? DEATH_REWARD : 0.0f);
+        env.done = terminated || truncated;
+        finished += env.done;
+        observe(env, i, slot, restarted ? nullptr : previousSlot, reward, truncated);
+    }
+    episodes += finished;
+}
+
+void EnvServer::observe(const Env& env, uint32_t index, uint8_t* slot, const uint8_t* previousSlot, float reward,
+                        bool truncated) const {
+    const Simulation& sim = env.sim;
+    const Simulation::Rect& bird = sim.getBird();
+    EnvProtocol::Observation& obs =
+        reinterpret_cast<EnvProtocol::Observation*>(slot + sizeof(EnvProtocol::SlotHeader))[index];
+    obs.birdY = static_cast<float>(bird.y);
+    obs.birdVelocity = sim.getBirdVelocity();
+    // Без труб впереди зазор — вся высота над землёй
+    obs.gapDistance = static_cast<float>(Simulation::SCREEN_WIDTH - bird.x);
+    obs.gapTop = 0.0f;
+    obs.gapBottom = static_cast<float>(Simulation::SCREEN_HEIGHT - Simulation::GROUND_HEIGHT);
+    for (const auto& pipe : sim.getPipes()) {
+        if (pipe.x + Simulation::PIPE_WIDTH >= bird.x) {
+            obs.gapDistance = static_cast<float>(pipe.x + Simulation::PIPE_WIDTH - bird.x);
+            obs.gapTop = static_cast<float>(pipe.gapTop);
+            obs.gapBottom = static_cast<float>(pipe.gapTop + pipe.gapHeight);
+            break;
+        }
+    }
+    obs.reward = reward;
+    obs.score = sim.getScore();
+    obs.terminated = sim.getState() == Simulation::GAME_OVER;
+    obs.truncated = truncated;
+    obs.reserved[0] = obs.reserved[1] = 0;
+
+    if (rasterizer) {
+        const uint64_t offset = header->framesOffset + index * stackBytes;
+        rasterizer->renderStacked(sim, previousSlot ? previousSlot + offset : nullptr, slot + offset,
+                                  static_cast<int>(config.frameStack));
+    }
+}
+
+void EnvServer::publish(uint8_t* slot) {
+    EnvProtocol::SlotHeader* slotHeader = reinterpret_cast<EnvProtocol::SlotHeader*>(slot);
+    slotHeader->sequence = sequence;
+    slotHeader->episodes = episodes;
+    reply.status = EnvProtocol::STATUS_OK;
+    reply.slot = static_cast<uint32_t>(sequence % EnvProtocol::SLOT_COUNT);
+    reply.sequence = sequence;
+    sequence++;
+}
+
+uint8_t* EnvServer::getActions() const {
+    return reinterpret_cast<uint8_t*>(header) + header->actionsOffset;
+}
+
+const EnvProtocol::Observation* EnvServer::getObservations(uint32_t slot) const {
+    return reinterpret_cast<const EnvProtocol::Observation*>(slotData(slot) + sizeof(EnvProtocol::SlotHeader));
+}
+
+const uint8_t* EnvServer::getFrames(uint32_t slot, uint32_t env) const {
+    if (!rasterizer) {
+        return nullptr;
+    }
+    return slotData(slot) + header->framesOffset + env * stackBytes;
+}
+
+uint8_t* EnvServer::slotData(uint32_t slot) const {
+    return reinterpret_cast<uint8_t*>(header) + header->slotsOffset + static_cast<uint64_t>(slot) * header->slotBytes;
+}
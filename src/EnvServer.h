@@ -0,0 +1,92 @@
+#ifndef ENV_SERVER_H
+#define ENV_SERVER_H
+
+#include "EnvProtocol.h"
+#include "LocalSocket.h"
+#include "MappedFile.h"
+#include "ObservationRasterizer.h"
+#include "Simulation.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+class ThreadPool;
+
+struct EnvServerConfig {
+    std::string socketPath;
+    std::string sharedMemoryPath;         // Пустой — socketPath + ".shm"
+    uint32_t envCount = 1;
+    uint32_t frameWidth = 0;              // 0 — без кадров
+    uint32_t frameHeight = 0;
+    uint32_t frameStack = 1;              // Последних кадров в наблюдении
+    unsigned threads = 1;                 // 0 — по числу ядер
+    uint64_t seed = 1;
+    uint64_t maxTicksPerEpisode = 100000;
+};
+
+// Сервер сред для обучения с подкреплением: пакет независимых Simulation,
+// которые шагают одним запросом по локальному сокету (протокол — EnvProtocol.h).
+// Эпизод начинается сразу в PLAYING, как после первого нажатия SPACE.
+// Разбившаяся среда перезапускается на следующем шаге со следующим seed.
+class EnvServer {
+public:
+    static const uint64_t ENVS_PER_TASK = 256;
+    static const uint32_t MAX_FRAME_STACK = 16;
+
+    EnvServer();
+    ~EnvServer();
+
+    EnvServer(const EnvServer&) = delete;
+    EnvServer& operator=(const EnvServer&) = delete;
+
+    // Создаёт общую память и слушающий сокет
+    bool start(const EnvServerConfig& config);
+    // Обслуживает клиентов по одному до команды CLOSE
+    bool run();
+    void stop();
+
+    // Шаги без сокета, для встраивания и проверки
+    const EnvProtocol::Reply& reset(uint64_t seed);
+    const EnvProtocol::Reply& step();
+
+    const EnvProtocol::Header* getHeader() const { return header; }
+    uint8_t* getActions() const;
+    const EnvProtocol::Observation* getObservations(uint32_t slot) const;
+    // Стопка кадров среды, от старого к новому; nullptr, если кадры выключены
+    const uint8_t* getFrames(uint32_t slot, uint32_t env) const;
+
+private:
+    struct Env {
+        Simulation sim;
+        uint64_t episode = 0;
+        uint64_t ticks = 0;
+        bool done = false;
+    };
+
+    EnvServerConfig config;
+    std::vector<Env> envs;
+    std::unique_ptr<ThreadPool> pool;
+    std::unique_ptr<ObservationRasterizer> rasterizer;
+    uint64_t stackBytes;                  // Стопка кадров одной среды
+    MappedFile sharedMemory;
+    EnvProtocol::Header* header;
+    LocalSocket listener;
+    uint64_t sequence;
+    std::atomic<uint64_t> episodes;
+    EnvProtocol::Reply reply;
+
+    bool serveClient(LocalSocket& client, bool& closeRequested);
+    void startEpisode(Env& env, uint32_t index);
+    // Шаг сред [first, last) и запись их наблюдений в слот; стопки кадров
+    // продолжают стопки из previousSlot
+    void stepRange(uint32_t first, uint32_t last, uint8_t* slot, const uint8_t* previousSlot);
+    // previousSlot == nullptr — эпизод только начался, стопка заполняется первым кадром
+    void observe(const Env& env, uint32_t index, uint8_t* slot, const uint8_t* previousSlot, float reward,
+                 bool truncated) const;
+    void publish(uint8_t* slot);
+    uint8_t* slotData(uint32_t slot) const;
+};
+
+#endif // ENV_SERVER_H
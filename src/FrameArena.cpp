@@ -0,0 +1,45 @@
+#include "FrameArena.h"
+#include <cstdarg>
+#include <cstdio>
+
+FrameArena::FrameArena(size_t size) :
+    buffer(new unsigned char[size]),
+    capacity(size),
+    used(0),
+    peak(0),
+    overflows(0)
+{
+}
+
+void* FrameArena::allocate(size_t size, size_t alignment) {
+    const uintptr_t base = reinterpret_cast<uintptr_t>(buffer.get());
+    const uintptr_t aligned = (base + used + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1);
+    const size_t offset = aligned - base;
+    if (offset + size > capacity) {
+        overflows++;
+        return nullptr;
+    }
+    used = offset + size;
+    if (used > peak) {
+        peak = used;
+    }
+    return buffer.get() + offset;
+}
+
+const char* FrameArena::format(const char* fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    va_list sizeArgs;
+    va_copy(sizeArgs, args);
+    const int length = vsnprintf(nullptr, 0, fmt, sizeArgs);
+    va_end(sizeArgs);
+
+    char* text = length >= 0 ? allocateArray<char>(static_cast<size_t>(length) + 1) : nullptr;
+    if (!text) {
+        va_end(args);
+        return "";
+    }
+    vsnprintf(text, static_cast<size_t>(length) + 1, fmt, args);
+    va_end(args);
+    return text;
+}
@@ -0,0 +1,48 @@
+#ifndef FRAME_ARENA_H
+#define FRAME_ARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+// Линейный аллокатор для данных, живущих один кадр (строки надписей и т.п.).
+// Память выделяется один раз при создании; allocate() только сдвигает указатель,
+// а reset() в начале кадра освобождает всё сразу. Деструкторы не вызываются,
+// поэтому в арене хранятся только тривиальные типы.
+class FrameArena {
+public:
+    static const size_t DEFAULT_CAPACITY = 16 * 1024;
+
+    explicit FrameArena(size_t capacity = DEFAULT_CAPACITY);
+
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    // nullptr, если в арене не осталось места; кучу арена не трогает
+    void* allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+    template <typename T>
+    T* allocateArray(size_t count) { return static_cast<T*>(allocate(sizeof(T) * count, alignof(T))); }
+
+    // printf в память арены. При переполнении возвращает пустую строку
+    const char* format(const char* fmt, ...)
+#if defined(__GNUC__)
+        __attribute__((format(printf, 2, 3)))
+#endif
+        ;
+
+    void reset() { used = 0; }
+    size_t getUsed() const { return used; }
+    size_t getCapacity() const { return capacity; }
+    // Наибольшее заполнение за кадр и число отказов — для подбора capacity
+    size_t getPeak() const { return peak; }
+    uint64_t getOverflows() const { return overflows; }
+
+private:
+    std::unique_ptr<unsigned char[]> buffer;
+    size_t capacity;
+    size_t used;
+    size_t peak;
+    uint64_t overflows;
+};
+
+#endif // FRAME_ARENA_H
@@ -0,0 +1,147 @@
+#include "FrameCapture.h"
+#include "Profiler.h"
+#include <SDL_image.h>
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+FrameCapture::FrameCapture() :
+    format(FORMAT_RAW),
+    width(0),
+    height(0),
+    stopping(false),
+    failed(false),
+    startUs(0)
+{
+}
+
+FrameCapture::~FrameCapture() {
+    finish();
+}
+
+bool FrameCapture::start(const std::string& path, Format value, int w, int h, size_t poolSize) {
+    finish();
+    std::error_code error;
+    std::filesystem::create_directories(path, error);
+    if (error) {
+        std::cout << "Failed to create capture directory " << path << ": " << error.message() << std::endl;
+        return false;
+    }
+    directory = path;
+    format = value;
+    width = w;
+    height = h;
+    stats = Stats();
+    stopping = false;
+    failed = false;
+
+    storage.clear();
+    freeFrames.clear();
+    for (size_t i = 0; i < std::max<size_t>(poolSize, 1); i++) {
+        storage.push_back(std::make_unique<Frame>());
+        storage.back()->pixels.resize(static_cast<size_t>(width) * height * 4);
+        freeFrames.push_back(storage.back().get());
+    }
+
+    startUs = Profiler::nowUs();
+    encoder = std::thread(&FrameCapture::encodeLoop, this);
+    return true;
+}
+
+bool FrameCapture::capture(SDL_Renderer* renderer) {
+    PROFILE_SCOPE("capture");
+    Frame* frame = nullptr;
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        if (freeFrames.empty()) {
+            stats.stalls++;
+            frameFreed.wait(lock, [this] { return !freeFrames.empty() || failed; });
+        }
+        if (failed) {
+            return false;
+        }
+        frame = freeFrames.back();
+        freeFrames.pop_back();
+    }
+
+    const uint64_t readStart = Profiler::nowUs();
+    if (SDL_RenderReadPixels(renderer, nullptr, SDL_PIXELFORMAT_ARGB8888, frame->pixels.data(), width * 4) < 0) {
+        std::cout << "Failed to read back frame: " << SDL_GetError() << std::endl;
+        std::lock_guard<std::mutex> lock(mutex);
+        freeFrames.push_back(frame);
+        return false;
+    }
+    stats.readbackMs += (Profiler::nowUs() - readStart) / 1000.0;
+    frame->index = stats.frames++;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        readyFrames.push_back(frame);
+    }
+    frameReady.notify_one();
+    return true;
+}
+
+void FrameCapture::finish() {
+    if (!encoder.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    frameReady.notify_one();
+    encoder.join();
+    stats.seconds = (Profiler::nowUs() - startUs) / 1000000.0;
+}
+
+void FrameCapture::encodeLoop() {
+    for (;;) {
+        Frame* frame = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            frameReady.wait(lock, [this] { return !readyFrames.empty() || stopping; });
+            if (readyFrames.empty()) {
+                return;
+            }
+            frame = readyFrames.front();
+            readyFrames.pop_front();
+        }
+
+        const bool ok = writeFrame(*frame);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            freeFrames.push_back(frame);
+            failed = failed || !ok;
+        }
+        frameFreed.notify_one();
+    }
+}
+
+bool FrameCapture::writeFrame(const Frame& frame) {
+    PROFILE_SCOPE("encodeFrame");
+    char name[32];
+    snprintf(name, sizeof(name), "/frame_%06llu.%s", static_cast<unsigned long long>(frame.index),
+             format == FORMAT_PNG ? "png" : "raw");
+    const std::string path = directory + name;
+
+    if (format == FORMAT_RAW) {
+        std::ofstream file(path, std::ios::binary);
+        if (!file.write(reinterpret_cast<const char*>(frame.pixels.data()), frame.pixels.size())) {
+            std::cout << "Failed to write " << path << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormatFrom(const_cast<uint8_t*>(frame.pixels.data()),
+        width, height, 32, width * 4, SDL_PIXELFORMAT_ARGB8888);
+    const bool ok = surface && IMG_SavePNG(surface, path.c_str()) == 0;
+    if (!ok) {
+        std::cout << "Failed to write " << path << ": " << IMG_GetError() << std::endl;
+    }
+    SDL_FreeSurface(surface);
+    return ok;
+}
@@ -0,0 +1,76 @@
+#ifndef FRAME_CAPTURE_H
+#define FRAME_CAPTURE_H
+
+#include <SDL.h>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Захват кадров рендерера в последовательность файлов. Кадр считывается
+// SDL_RenderReadPixels в буфер из пула и передаётся фоновому потоку-кодировщику,
+// так что запись на диск и сжатие PNG идут параллельно с рендерингом.
+// Рендеринг ждёт только тогда, когда кодировщик отстал на весь пул.
+class FrameCapture {
+public:
+    enum Format {
+        FORMAT_RAW,     // frame_000000.raw: ширина*высота пикселей ARGB8888 (BGRA в памяти)
+        FORMAT_PNG      // frame_000000.png
+    };
+
+    struct Stats {
+        uint64_t frames = 0;
+        uint64_t stalls = 0;        // Сколько раз рендеринг ждал свободный буфер
+        double readbackMs = 0;      // Суммарное время SDL_RenderReadPixels
+        double seconds = 0;         // От start() до окончания записи последнего кадра
+    };
+
+    static const size_t DEFAULT_POOL_SIZE = 8;
+
+    FrameCapture();
+    ~FrameCapture();
+
+    FrameCapture(const FrameCapture&) = delete;
+    FrameCapture& operator=(const FrameCapture&) = delete;
+
+    bool start(const std::string& directory, Format format, int width, int height,
+               size_t poolSize = DEFAULT_POOL_SIZE);
+    // Считывает текущее содержимое цели рендеринга
+    bool capture(SDL_Renderer* renderer);
+    // Дожидается записи всех кадров и останавливает кодировщик
+    void finish();
+    const Stats& getStats() const { return stats; }
+
+private:
+    struct Frame {
+        std::vector<uint8_t> pixels;
+        uint64_t index;
+    };
+
+    std::string directory;
+    Format format;
+    int width;
+    int height;
+
+    std::vector<std::unique_ptr<Frame>> storage;
+    std::vector<Frame*> freeFrames;
+    std::deque<Frame*> readyFrames;
+    std::mutex mutex;
+    std::condition_variable frameFreed;
+    std::condition_variable frameReady;
+    bool stopping;
+    bool failed;
+    std::thread encoder;
+
+    Stats stats;
+    uint64_t startUs;
+
+    void encodeLoop();
+    bool writeFrame(const Frame& frame);
+};
+
+#endif // FRAME_CAPTURE_H
@@ -0,0 +1,40 @@
+#ifndef FRAME_LIMITER_H
+#define FRAME_LIMITER_H
+
+#include <SDL.h>
+
+// Точный ограничитель частоты кадров для режима без vsync: основную часть
+// интервала спит в SDL_Delay, последние SPIN_MS досчитывает активным ожиданием
+class FrameLimiter {
+public:
+    static constexpr double SPIN_MS = 2.0;
+
+    explicit FrameLimiter(double fps) :
+        frequency(SDL_GetPerformanceFrequency()),
+        interval(static_cast<Uint64>(frequency / fps)),
+        next(SDL_GetPerformanceCounter() + interval)
+    {
+    }
+
+    // Ждёт начала следующего кадра
+    void wait() {
+        Uint64 now = SDL_GetPerformanceCounter();
+        if (now < next) {
+            const double remainingMs = (next - now) * 1000.0 / frequency;
+            if (remainingMs > SPIN_MS) {
+                SDL_Delay(static_cast<Uint32>(remainingMs - SPIN_MS));
+            }
+            while ((now = SDL_GetPerformanceCounter()) < next) {
+            }
+        }
+        // После долгого кадра не пытаемся догнать пропущенные интервалы
+        next = (now - next > interval) ? now + interval : next + interval;
+    }
+
+private:
+    Uint64 frequency;
+    Uint64 interval;
+    Uint64 next;
+};
+
+#endif // FRAME_LIMITER_H
@@ -1,37 +1,50 @@
 #include "Game.h"
-#include <cstdlib>
+#include "ThreadPool.h"
 #include <ctime>
 #include <cmath>
 #include <string>
 #include <algorithm>
+#include <iterator>
+
+static const SDL_Color SCORE_COLOR = {255, 223, 0, 255};
 
 Game::Game() :
+    startupReported(false),
     window(nullptr),
     renderer(nullptr),
-    birdTexture(nullptr),
-    backgroundTexture(nullptr),
-    pipeTexture(nullptr),
-    groundTexture(nullptr),
+    offscreen(false),
+    offscreenSurface(nullptr),
+    lastTextMisses(0),
+    birdSprite(-1),
+    backgroundSprite(-1),
+    pipeSprite(-1),
+    groundSprite(-1),
     font(nullptr),
+    seed(0),
+    scoreLogPath(),
     isRunning(false),
-    birdVelocity(0),
-    birdAngle(0),
-    score(0),
-    scrollOffset(0),
-    gameState(WAITING),
-    gameTime(0),
-    gameSpeed(0.2f),
-    startTime(0),
-    accelerationFactor(0.0f),
-    gravity(INITIAL_GRAVITY),
-    jumpForce(INITIAL_JUMP_FORCE)
+    renderOnThread(false),
+    renderThreadRunning(false),
+    tickUs(0),
+    lowLatency(false),
+    targetFps(0),
+    pendingPressUs(0),
+    lastPresentedInputUs(0),
+    lastFrameStatic(false),
+    lastFrameHadGhosts(false),
+    redrawRequested(false),
+    renderTargetsLost(false),
+    scrollDistance(0),
+    lastScrollOffset(0),
+    lastBackgroundOffset(0),
+    lastGroundOffset(0),
+    lastDrawnState(Simulation::WAITING),
+    lastDrawnScore(0),
+    softwareRenderer(false),
+    showProfilerOverlay(false),
+    overlayUpdatedUs(0)
 {
-    bird.x = SCREEN_WIDTH / 4;
-    bird.y = SCREEN_HEIGHT / 2;
-    bird.w = BIRD_WIDTH;
-    bird.h = BIRD_HEIGHT;
-
-    srand(static_cast<unsigned>(time(nullptr)));
+    setSeed(static_cast<uint64_t>(time(nullptr)));
 
     audio.backgroundMusic = nullptr;
     audio.musicEnabled = true;
@@ -45,97 +58,332 @@ Game::~Game() {
 }
 
 bool Game::init() {
-    if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_AUDIO) < 0) {
-        std::cout << "SDL initialization failed: " << SDL_GetError() << std::endl;
-        return false;
+    {
+        StartupTimer::Scope step(startup, "SDL_Init video");
+        if (SDL_Init(SDL_INIT_VIDEO) < 0) {
+            std::cout << "SDL initialization failed: " << SDL_GetError() << std::endl;
+            return false;
+        }
     }
 
-    if (!(IMG_Init(IMG_INIT_PNG) & IMG_INIT_PNG)) {
-        std::cout << "SDL_image initialization failed: " << IMG_GetError() << std::endl;
-        return false;
+    {
+        StartupTimer::Scope step(startup, "IMG_Init, TTF_Init");
+        if (!(IMG_Init(IMG_INIT_PNG) & IMG_INIT_PNG)) {
+            std::cout << "SDL_image initialization failed: " << IMG_GetError() << std::endl;
+            return false;
+        }
+        if (TTF_Init() < 0) {
+            std::cout << "SDL_ttf initialization failed: " << TTF_GetError() << std::endl;
+            return false;
+        }
     }
 
-    if (TTF_Init() < 0) {
-        std::cout << "SDL_ttf initialization failed: " << TTF_GetError() << std::endl;
-        return false;
+    {
+        // Упакованный архив отображается в память; без него ресурсы читаются из отдельных файлов
+        StartupTimer::Scope step(startup, "map assets.pak");
+        if (!archive.open("assets.pak")) {
+            startup.mark("no assets.pak, loose files");
+        }
     }
 
-    if (!initAudio()) {
-        return false;
+    // Всё, что не требует окна, идёт в фоне: аудиоустройство со звуками и музыкой,
+    // шрифт и спрайты. Главный поток тем временем показывает окно и первый кадр
+    const size_t soundCount = std::size(AssetManifest::SOUNDS);
+    SDL_Surface* sprites[AssetManifest::SPRITE_COUNT] = {};
+    std::vector<Mix_Chunk*> sounds(soundCount, nullptr);
+    TTF_Font* loadedFont = nullptr;
+    ThreadPool loader;
+
+    // Подсистемы SDL инициализируются только в главном потоке: SDL_InitSubSystem
+    // не потокобезопасен, а рядом создаются окно и рендерер. В фон уходит открытие
+    // устройства микшером и декодирование звуков
+    bool audioAvailable = false;
+    {
+        StartupTimer::Scope step(startup, "SDL_Init audio");
+        audioAvailable = SDL_InitSubSystem(SDL_INIT_AUDIO) == 0;
+        if (!audioAvailable) {
+            std::cout << "Warning: SDL audio initialization failed: " << SDL_GetError() << std::endl;
+        }
     }
 
-    window = SDL_CreateWindow("Flappy Bird", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED,
-        SCREEN_WIDTH, SCREEN_HEIGHT, SDL_WINDOW_SHOWN);
-    if (!window) {
-        std::cout << "Window creation failed: " << SDL_GetError() << std::endl;
-        return false;
+    loader.submit([this, &loader, &sounds, soundCount, audioAvailable] {
+        if (!audioAvailable || !initAudio()) {
+            return;
+        }
+        for (size_t i = 0; i < soundCount; i++) {
+            loader.submit([this, &sounds, i] {
+                StartupTimer::Scope step(startup, AssetManifest::SOUNDS[i].path);
+                sounds[i] = loadSound(AssetManifest::SOUNDS[i]);
+            });
+        }
+        StartupTimer::Scope step(startup, AssetManifest::MUSIC_PATH);
+        SDL_RWops* musicData = openAsset(AssetManifest::MUSIC_PATH);
+        audio.backgroundMusic = musicData ? Mix_LoadMUS_RW(musicData, 1) : nullptr;
+        if (!audio.backgroundMusic) {
+            std::cout << "Warning: Failed to load background music: " << Mix_GetError() << std::endl;
+        }
+    });
+    loader.submit([this, &loadedFont] {
+        StartupTimer::Scope step(startup, AssetManifest::FONT_PATH);
+        SDL_RWops* fontData = openAsset(AssetManifest::FONT_PATH);
+        loadedFont = fontData ? TTF_OpenFontRW(fontData, 1, 28) : nullptr;
+    });
+    if (!scoreLogPath.empty()) {
+        // Индекс таблицы догоняет журнал, пока грузятся ресурсы; без таблицы игра работает
+        loader.submit([this] {
+            StartupTimer::Scope step(startup, "open score log");
+            scores.open(scoreLogPath);
+        });
+    }
+    for (int i = 0; i < AssetManifest::SPRITE_COUNT; i++) {
+        loader.submit([this, &sprites, i] {
+            StartupTimer::Scope step(startup, AssetManifest::SPRITES[i].path);
+            sprites[i] = loadSpriteSurface(AssetManifest::SPRITES[i]);
+        });
     }
 
-    renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
-    if (!renderer) {
-        std::cout << "Renderer creation failed: " << SDL_GetError() << std::endl;
+    // Окно живёт в главном потоке, где опрашиваются события. В конвейерном режиме
+    // рендерер создаёт поток рендеринга (startRenderThread)
+    const bool rendererOnThread = renderOnThread && !offscreen;
+    if (!offscreen) {
+        StartupTimer::Scope step(startup, "create window");
+        window = SDL_CreateWindow("Flappy Bird", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED,
+            SCREEN_WIDTH, SCREEN_HEIGHT, SDL_WINDOW_SHOWN);
+        if (!window) {
+            std::cout << "Window creation failed: " << SDL_GetError() << std::endl;
+            return false;
+        }
+    }
+    if (!rendererOnThread && !createRenderer()) {
         return false;
     }
 
-    birdTexture = loadTexture("assets/bird.png");
-    backgroundTexture = loadTexture("assets/background.png");
-    pipeTexture = loadTexture("assets/pipe.png");
-    groundTexture = loadTexture("assets/ground.png");
+    {
+        StartupTimer::Scope step(startup, "wait for background loading");
+        loader.wait();
+    }
 
-    font = TTF_OpenFont("assets/font.ttf", 28);
+    font = loadedFont;
     if (!font) {
         std::cout << "Failed to load font: " << TTF_GetError() << std::endl;
         return false;
     }
+    spriteBatch.reserve(Simulation::MAX_PIPES * 2 + 5 + ghosts.size());
+    dirtyRegion.reserve(Simulation::MAX_PIPES * 2 + 1);
 
-    if (!birdTexture || !backgroundTexture || !pipeTexture || !groundTexture) {
+    for (size_t i = 0; i < soundCount; i++) {
+        audio.effects.setSound(static_cast<AssetManifest::SoundId>(i), sounds[i]);
+    }
+    setMusicVolume(audio.musicVolume);
+    setSoundVolume(audio.soundVolume);
+    audio.effects.start();
+
+    // Все спрайты упаковываются в один атлас в порядке манифеста; текстура
+    // атласа загружается вместе с остальными ресурсами рендерера
+    int* spriteIds[AssetManifest::SPRITE_COUNT] = {&birdSprite, &backgroundSprite, &pipeSprite, &groundSprite};
+    bool spritesLoaded = true;
+    for (int i = 0; i < AssetManifest::SPRITE_COUNT; i++) {
+        *spriteIds[i] = atlas.addPrepared(sprites[i]);
+        spritesLoaded = spritesLoaded && *spriteIds[i] >= 0;
+    }
+    if (!spritesLoaded || (!rendererOnThread && !createRenderResources())) {
         return false;
     }
+    lastScrollOffset = sim.getScrollOffset();
 
     isRunning = true;
-    createPipe(); // Создаем первую трубу при инициализации
     playMusic();
     return true;
 }
 
-SDL_Texture* Game::loadTexture(const std::string& path) {
-    SDL_Surface* surface = IMG_Load(path.c_str());
-    if (!surface) {
+bool Game::createRenderer() {
+    if (offscreen) {
+        // Программный рендерер рисует прямо в поверхность; окно и vsync не нужны
+        StartupTimer::Scope step(startup, "create offscreen renderer");
+        offscreenSurface = SDL_CreateRGBSurfaceWithFormat(0, SCREEN_WIDTH, SCREEN_HEIGHT, 32, SDL_PIXELFORMAT_ARGB8888);
+        renderer = offscreenSurface ? SDL_CreateSoftwareRenderer(offscreenSurface) : nullptr;
+        if (!renderer) {
+            std::cout << "Offscreen renderer creation failed: " << SDL_GetError() << std::endl;
+            return false;
+        }
+    }
+    else {
+        StartupTimer::Scope step(startup, "create renderer");
+        const Uint32 flags = lowLatency ? SDL_RENDERER_ACCELERATED : SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC;
+        renderer = SDL_CreateRenderer(window, -1, flags);
+        if (!renderer) {
+            std::cout << "Renderer creation failed: " << SDL_GetError() << std::endl;
+            return false;
+        }
+    }
+
+    // Окно сразу получает кадр цвета неба вместо чёрного экрана на время загрузки
+    {
+        StartupTimer::Scope step(startup, "present loading frame");
+        SDL_SetRenderDrawColor(renderer, 112, 197, 206, 255);
+        SDL_RenderClear(renderer);
+        SDL_RenderPresent(renderer);
+        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+    }
+
+    StartupTimer::Scope step(startup, "create menu panel");
+    if (!menuPanel.create(renderer, 20, SDL_Color{0, 0, 0, 100})) {
+        return false;
+    }
+    menuCache.create(renderer, SCREEN_WIDTH, SCREEN_HEIGHT);
+    return true;
+}
+
+bool Game::createRenderResources() {
+    textCache.init(renderer, font);
+    // Цифры счёта растеризуются заранее: новый счёт в кадре не требует выделений памяти
+    for (char digit = '0'; digit <= '9'; digit++) {
+        const char glyph[2] = {digit, '\0'};
+        textCache.get(glyph, SCORE_COLOR);
+    }
+    // Подписи экрана конца игры тоже, чтобы первый проигрыш не ждал растеризации
+    for (const char* label : {"Final Score: ", "Best: ", "   Record: ", "Better than ", "% of runs"}) {
+        textCache.get(label, SCORE_COLOR);
+    }
+
+    {
+        StartupTimer::Scope step(startup, "atlas upload");
+        if (!atlas.build(renderer)) {
+            return false;
+        }
+    }
+
+    {
+        // Фон и земля масштабируются один раз; без текстур-целей они рисуются спрайтами из атласа
+        StartupTimer::Scope step(startup, "compose scroll layers");
+        backgroundLayer.create(renderer, SDL_Rect{0, 0, SCREEN_WIDTH, SCREEN_HEIGHT}, BACKGROUND_PARALLAX, true);
+        groundLayer.create(renderer, SDL_Rect{0, SCREEN_HEIGHT - Simulation::GROUND_HEIGHT, SCREEN_WIDTH,
+                                              Simulation::GROUND_HEIGHT}, GROUND_PARALLAX, false);
+        composeLayers();
+    }
+
+    // Содержимое кадра сохраняется между present только у программного рендерера
+    SDL_RendererInfo info;
+    softwareRenderer = SDL_GetRendererInfo(renderer, &info) == 0 && (info.flags & SDL_RENDERER_SOFTWARE);
+    return true;
+}
+
+void Game::destroyRenderer() {
+    atlas.destroy();
+    if (renderer) {
+        const TextCache::Stats& stats = textCache.getStats();
+        std::cout << "Text cache: " << stats.hits << " hits, " << stats.misses << " misses, "
+                  << stats.evictions << " evictions" << std::endl;
+        std::cout << "Last frame: " << renderStats.drawCalls << " draw calls, "
+                  << renderStats.textureSwitches << " texture switches, "
+                  << renderStats.sprites << " batched sprites" << std::endl;
+        inputLatency.report(std::cout, lowLatency ? "Input latency (low-latency mode)" : "Input latency");
+    }
+    textCache.clear();
+    menuPanel.destroy();
+    menuCache.destroy();
+    backgroundLayer.destroy();
+    groundLayer.destroy();
+
+    if (renderer) {
+        SDL_DestroyRenderer(renderer);
+        renderer = nullptr;
+    }
+    if (offscreenSurface) {
+        SDL_FreeSurface(offscreenSurface);
+        offscreenSurface = nullptr;
+    }
+}
+
+SDL_RWops* Game::openAsset(const char* path) {
+    if (const AssetArchive::Entry* entry = archive.find(path)) {
+        return SDL_RWFromConstMem(entry->data, static_cast<int>(entry->size));
+    }
+    return SDL_RWFromFile((std::string("assets/") + path).c_str(), "rb");
+}
+
+SDL_Surface* Game::loadSpriteSurface(const AssetManifest::Sprite& sprite) {
+    // Из архива пиксели берутся без копирования: поверхность смотрит прямо в отображённый файл
+    const AssetArchive::Entry* entry = archive.find(sprite.name);
+    if (entry && entry->type == AssetArchive::TYPE_IMAGE &&
+        entry->size == static_cast<size_t>(entry->width) * entry->height * 4) {
+        SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormatFrom(const_cast<unsigned char*>(entry->data),
+            entry->width, entry->height, 32, entry->width * 4, entry->format);
+        // Архив от другой версии манифеста приводится к нужному размеру копированием
+        if (surface && (entry->format != AssetManifest::PIXEL_FORMAT ||
+                        entry->width > sprite.maxWidth || entry->height > sprite.maxHeight)) {
+            SDL_Surface* prepared = TextureAtlas::prepare(surface, sprite.maxWidth, sprite.maxHeight);
+            SDL_FreeSurface(surface);
+            surface = prepared;
+        }
+        if (surface) {
+            return surface;
+        }
+    }
+
+    const std::string path = std::string("assets/") + sprite.path;
+    SDL_Surface* loaded = IMG_Load(path.c_str());
+    if (!loaded) {
         std::cout << "Failed to load image " << path << ": " << IMG_GetError() << std::endl;
         return nullptr;
     }
+    SDL_Surface* prepared = TextureAtlas::prepare(loaded, sprite.maxWidth, sprite.maxHeight);
+    SDL_FreeSurface(loaded);
+    if (!prepared) {
+        std::cout << "Failed to add " << path << " to the texture atlas" << std::endl;
+    }
+    return prepared;
+}
 
-    SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
-    SDL_FreeSurface(surface);
+Mix_Chunk* Game::loadSound(const AssetManifest::Sound& sound) {
+    // PCM из архива уже в формате микшера и проигрывается прямо из отображённого файла
+    int frequency = 0, channels = 0;
+    Uint16 format = 0;
+    const AssetArchive::Entry* entry = archive.find(sound.name);
+    if (entry && entry->type == AssetArchive::TYPE_SOUND && Mix_QuerySpec(&frequency, &format, &channels) &&
+        entry->width == frequency && entry->height == channels && entry->format == format) {
+        Mix_Chunk* chunk = Mix_QuickLoad_RAW(const_cast<unsigned char*>(entry->data), static_cast<Uint32>(entry->size));
+        if (chunk) {
+            return chunk;
+        }
+    }
 
-    if (!texture) {
-        std::cout << "Failed to create texture from " << path << ": " << SDL_GetError() << std::endl;
+    const std::string path = std::string("assets/") + sound.path;
+    Mix_Chunk* chunk = Mix_LoadWAV(path.c_str());
+    if (!chunk) {
+        std::cout << "Warning: Failed to load sound effect " << sound.name << ": " << Mix_GetError() << std::endl;
     }
-    return texture;
+    return chunk;
+}
+
+// Время события по часам профилировщика; SDL ставит метку в мс по SDL_GetTicks
+static uint64_t eventTimeUs(Uint32 timestamp) {
+    const uint64_t now = Profiler::nowUs();
+    const uint64_t ageUs = static_cast<uint64_t>(SDL_GetTicks() - timestamp) * 1000;
+    return ageUs < now ? now - ageUs : now;
 }
 
 void Game::handleEvents() {
+    PROFILE_SCOPE("handleEvents");
     SDL_Event event;
     while (SDL_PollEvent(&event)) {
         if (event.type == SDL_QUIT) {
             isRunning = false;
         }
+        else if (event.type == SDL_WINDOWEVENT) {
+            redrawRequested = true;
+        }
+        else if (event.type == SDL_RENDER_TARGETS_RESET || event.type == SDL_RENDER_DEVICE_RESET) {
+            renderTargetsLost = true;
+            redrawRequested = true;
+        }
         else if (event.type == SDL_KEYDOWN) {
             switch (event.key.keysym.sym) {
                 case SDLK_SPACE:
-                    if (gameState == WAITING) {
-                        gameState = PLAYING;
-                        startTime = SDL_GetTicks();
-                        gameTime = 0;
-                        birdVelocity = 0;
-                        jump();
-                    }
-                    else if (gameState == PLAYING) {
-                        jump();
-                    }
-                    else if (gameState == GAME_OVER) {
-                        resetGame();
+                    if (!pendingInput.flap) {
+                        pendingPressUs = eventTimeUs(event.key.timestamp);
                     }
+                    pendingInput.flap = true;
                     break;
                 case SDLK_m:
                     toggleMusic();
@@ -149,297 +397,503 @@ void Game::handleEvents() {
                 case SDLK_DOWN:
                     setMusicVolume(std::max(audio.musicVolume - 8, 0));
                     break;
+                case SDLK_F3:
+                    showProfilerOverlay = !showProfilerOverlay;
+                    redrawRequested = true;
+                    if (showProfilerOverlay) {
+                        Profiler::instance().setEnabled(true);
+                    }
+                    break;
             }
         }
     }
 }
 void Game::update() {
-    if (gameState == WAITING) {
-        bird.y = SCREEN_HEIGHT / 2 + sin(SDL_GetTicks() / 500.0) * 30;
-        scrollOffset -= 0.5;
-        if (scrollOffset <= -SCREEN_WIDTH) {
-            scrollOffset = 0;
+    PROFILE_SCOPE("update");
+    frame.prevBirdY = static_cast<float>(sim.getBird().y);
+    frame.prevBirdAngle = sim.getBirdAngle();
+    frame.prevScrollOffset = sim.getScrollOffset();
+    const Simulation::State stateBefore = sim.getState();
+    const bool wasPlaying = stateBefore == Simulation::PLAYING;
+
+    uint32_t events = sim.step(pendingInput);
+    recorder.recordStep(sim, pendingInput);
+    // Длиннее Replay::MAX_TICKS запись не загрузится: сохраняем то, что есть
+    if (recorder.isActive() && sim.getTick() >= Replay::MAX_TICKS) {
+        saveRecording();
+    }
+    if (pendingInput.flap) {
+        frame.inputUs = pendingPressUs;
+    }
+    pendingInput = Simulation::Input();
+    if (wasPlaying && sim.getState() == Simulation::GAME_OVER) {
+        recordRun();
+    }
+    // Новый забег сразу после проигрыша: отложенный звук смерти не должен прозвучать в нём
+    if (stateBefore == Simulation::GAME_OVER && sim.getState() != Simulation::GAME_OVER) {
+        audio.effects.haltAll();
+    }
+
+    // Заезд призраков начинается с первым взмахом игрока и заканчивается с его проигрышем
+    if (ghosts.size() > 0) {
+        if (stateBefore == Simulation::WAITING && sim.getState() == Simulation::PLAYING) {
+            ghosts.start();
         }
+        else if (sim.getState() != Simulation::PLAYING) {
+            ghosts.stop();
+        }
+        ghosts.step(frame.ghosts);
+    }
+
+    // Трубы двигаются ровно на PIPE_SPEED за шаг, пока идёт игра
+    frame.pipeShift = (wasPlaying && sim.getState() == Simulation::PLAYING) ? Simulation::PIPE_SPEED : 0.0f;
+    handleSimEvents(events);
+    captureFrame();
+
+    if (isPipelined()) {
+        snapshots.writeBuffer() = frame;
+        snapshots.publish();
+    }
+}
+
+void Game::recordRun() {
+    RunSummary& summary = frame.summary;
+    summary.run++;
+    if (!scores.isOpen()) {
         return;
     }
 
-    if (gameState != PLAYING) {
+    // Запись дописывается в журнал, статистика берётся из индекса за микросекунды
+    const ScoreStore::Record run = {sim.getScore(), sim.getGameTime(), seed,
+                                    static_cast<int64_t>(time(nullptr)), scores.getCabinet()};
+    if (!scores.append(run)) {
         return;
     }
+    ScoreStore::Record best;
+    summary.best = scores.personalBest(best) ? best.score : run.score;
+    summary.record = scores.top(&best, 1) ? best.score : run.score;
+    summary.beatPercent = static_cast<int>(std::floor(scores.fractionBelow(run.score) * 100.0));
+}
 
-    gameTime = SDL_GetTicks() - startTime;
+void Game::captureFrame() {
+    frame.state = sim.getState();
+    frame.score = sim.getScore();
+    frame.bird = sim.getBird();
+    frame.birdAngle = sim.getBirdAngle();
+    frame.scrollOffset = sim.getScrollOffset();
+    frame.pipes = sim.getPipes();
+    frame.showProfilerOverlay = showProfilerOverlay;
+    frame.publishedUs = Profiler::nowUs();
+}
 
-    // Обновление физики птицы
-    birdVelocity += gravity;
-    birdVelocity = std::min(birdVelocity, 2.5f);
-    bird.y += static_cast<int>(birdVelocity);
+bool Game::startRenderThread(double tickSeconds) {
+    // Рендерер, созданный в главном потоке, нельзя отдать другому: нужен setPipelined до init()
+    if (isPipelined() || !renderOnThread || renderer || !isRunning) {
+        return false;
+    }
+    tickUs = static_cast<uint64_t>(tickSeconds * 1000000.0);
+    captureFrame();
+    snapshots.writeBuffer() = frame;
+    snapshots.publish();
+
+    std::promise<bool> ready;
+    std::future<bool> created = ready.get_future();
+    renderThreadRunning = true;
+    renderThread = std::thread(&Game::renderLoop, this, &ready);
+    if (!created.get()) {
+        stopRenderThread();
+        isRunning = false;
+        std::cout << "Render thread failed to set up the renderer" << std::endl;
+        return false;
+    }
+    return true;
+}
 
-    if (birdVelocity < 0) {
-        birdAngle = -25.0f;
-    } else {
-        birdAngle = std::min(birdAngle + 1.0f, 70.0f);
+void Game::stopRenderThread() {
+    if (renderThread.joinable()) {
+        renderThreadRunning = false;
+        renderThread.join();
     }
+}
 
-    // Проверка столкновений со стенами
-    if (bird.y < 0) {
-        bird.y = 0;
-        birdVelocity = 0;
+void Game::renderLoop(std::promise<bool>* ready) {
+    // SDL2 разрешает пользоваться рендерером только потоку, который его создал,
+    // поэтому рендерер и все текстуры создаются и уничтожаются здесь
+    if (!createRenderer() || !createRenderResources()) {
+        destroyRenderer();
+        ready->set_value(false);
+        return;
     }
+    ready->set_value(true);
+
+    // Кадры идут в темпе present (vsync) или ограничителя; задержка драйвера не тормозит ввод и физику
+    Profiler& profiler = Profiler::instance();
+    FrameLimiter limiter(getTargetFps());
+    while (renderThreadRunning) {
+        if (lowLatency) {
+            limiter.wait();
+        }
+        profiler.beginFrame();
+        snapshots.update();
+        const FrameSnapshot& snapshot = snapshots.readBuffer();
+        const float alpha = std::min(1.0f, static_cast<float>(Profiler::nowUs() - snapshot.publishedUs) /
+                                           static_cast<float>(std::max<uint64_t>(tickUs, 1)));
+        const bool drawn = renderFrame(snapshot, alpha);
+        // Кадр без перерисовки тоже попадает в историю кадров, но без ожидания снимка
+        profiler.endFrame();
+        if (!drawn) {
+            SDL_Delay(static_cast<Uint32>(tickUs / 1000));  // Неподвижный кадр: ждём следующего снимка
+        }
+    }
+    destroyRenderer();
+}
 
-    // Проверка столкновения с землей
-    if (bird.y + bird.h > SCREEN_HEIGHT - 100) {
-        bird.y = SCREEN_HEIGHT - 100 - bird.h;
-        if (gameState == PLAYING) {
-            Mix_HaltChannel(-1);  // Останавливаем все текущие звуки
-            playSound("hit");     // Звук удара
-            SDL_Delay(100);       // Небольшая задержка
-            playSound("die");     // Звук смерти
-            gameState = GAME_OVER;
+void Game::handleSimEvents(uint32_t events) {
+    if (events & Simulation::EVENT_HIT) {
+        audio.effects.haltAll();                // Останавливаем все текущие звуки
+        playSound(AssetManifest::SOUND_HIT);    // Немедленно проигрываем звук удара
+        if (events & Simulation::EVENT_DIE) {
+            // Звук смерти с небольшой задержкой; её выдерживает аудиопоток, а не игровой цикл
+            playSound(AssetManifest::SOUND_DIE, 100);
         }
         return;
     }
-
-    // Обновление фона
-    scrollOffset -= 1.0f;
-    if (scrollOffset <= -SCREEN_WIDTH) {
-        scrollOffset = 0;
+    if (events & Simulation::EVENT_JUMP) {
+        playSound(AssetManifest::SOUND_JUMP);
     }
+    if (events & Simulation::EVENT_SCORE) {
+        playSound(AssetManifest::SOUND_SCORE);
+    }
+}
 
-    // Создание первой трубы, если их нет
-    if (pipes.empty() && gameState == PLAYING) {
-        createPipe();
+bool Game::render(float alpha) {
+    captureFrame();
+    return renderFrame(frame, alpha);
+}
+
+bool Game::renderFrame(const FrameSnapshot& snapshot, float alpha) {
+    // Экран конца игры без оверлея неподвижен: он рисуется один раз и затем
+    // только по запросу (окно перекрыли, сброс устройства)
+    const bool isStatic = snapshot.state == Simulation::GAME_OVER && !snapshot.showProfilerOverlay;
+    const bool redraw = redrawRequested.exchange(false);
+    if (renderTargetsLost.exchange(false)) {
+        menuCache.invalidate();
+        backgroundLayer.invalidate();
+        groundLayer.invalidate();
+    }
+    if (isStatic && lastFrameStatic && !redraw) {
+        return false;
+    }
+    lastFrameStatic = isStatic;
+    if (isStatic) {
+        alpha = 1.0f;
     }
 
-    updatePipes();
+    PROFILE_SCOPE("render");
+    frameArena.reset();
+    renderStats = RenderStats();
+    const bool layersComposed = composeLayers();
 
-    // Проверка столкновений с трубами
-    if (checkCollision() && gameState == PLAYING) {
-        Mix_HaltChannel(-1);  // Останавливаем все текущие звуки
-        playSound("hit");     // Немедленно проигрываем звук удара
-        gameState = GAME_OVER;
+    const Simulation::State gameState = snapshot.state;
+    const int score = snapshot.score;
+
+    // Интерполяция между предыдущим и текущим шагом симуляции
+    float scrollOffset = snapshot.scrollOffset;
+    if (std::fabs(scrollOffset - snapshot.prevScrollOffset) < SCREEN_WIDTH / 2) {
+        scrollOffset = snapshot.prevScrollOffset + (scrollOffset - snapshot.prevScrollOffset) * alpha;
+    }
+    const Simulation::Rect& bird = snapshot.bird;
+    const float birdY = snapshot.prevBirdY + (bird.y - snapshot.prevBirdY) * alpha;
+    const float birdAngle = snapshot.prevBirdAngle + (snapshot.birdAngle - snapshot.prevBirdAngle) * alpha;
+    const float pipeOffset = snapshot.pipeShift * (1.0f - alpha);
+
+    // scrollOffset заворачивается каждые SCREEN_WIDTH пикселей, а слоям с параллаксом
+    // нужен весь пройденный путь
+    float scrollDelta = scrollOffset - lastScrollOffset;
+    if (scrollDelta > SCREEN_WIDTH / 2) {
+        scrollDelta -= SCREEN_WIDTH;
+    }
+    else if (scrollDelta < -SCREEN_WIDTH / 2) {
+        scrollDelta += SCREEN_WIDTH;
+    }
+    scrollDistance += scrollDelta;
+    lastScrollOffset = scrollOffset;
+    const int backgroundOffset = backgroundLayer.offsetFor(scrollDistance);
+    const int groundOffset = groundLayer.offsetFor(scrollDistance);
+
+    SDL_FRect pipeRects[Simulation::MAX_PIPES * 2];
+    int pipeCount = 0;
+    for (const auto& pipe : snapshot.pipes) {
+        const Simulation::Rect rects[2] = {pipe.topRect(), pipe.bottomRect()};
+        for (const auto& rect : rects) {
+            pipeRects[pipeCount++] = SDL_FRect{rect.x + pipeOffset, static_cast<float>(rect.y),
+                                               static_cast<float>(rect.w), static_cast<float>(rect.h)};
+        }
+    }
+    const SDL_FRect birdRect = {static_cast<float>(bird.x), birdY, static_cast<float>(bird.w), static_cast<float>(bird.h)};
+
+    // Перерисовывается только место подвижных спрайтов в прошлом и текущем кадре
+    // и полоса земли, если она сдвинулась. Фон занимает весь кадр, поэтому его
+    // сдвиг, как и новое меню или счёт, требует полного кадра
+    dirtyRegion.begin();
+    for (int i = 0; i < pipeCount; i++) {
+        dirtyRegion.add(pipeRects[i]);
+    }
+    dirtyRegion.add(birdRect, birdAngle);
+    if (groundOffset != lastGroundOffset) {
+        dirtyRegion.addArea(groundLayer.getArea());
+    }
+    // Тысячи призраков перерисовываются целиком, пока они на экране
+    const bool hasGhosts = !snapshot.ghosts.empty();
+    if (!softwareRenderer || redraw || layersComposed || snapshot.showProfilerOverlay ||
+        hasGhosts || lastFrameHadGhosts || backgroundOffset != lastBackgroundOffset ||
+        gameState != lastDrawnState || score != lastDrawnScore) {
+        dirtyRegion.invalidate();
+    }
+    lastFrameHadGhosts = hasGhosts;
+    lastBackgroundOffset = backgroundOffset;
+    lastGroundOffset = groundOffset;
+    lastDrawnState = gameState;
+    lastDrawnScore = score;
+
+    const SDL_Rect screen = {0, 0, SCREEN_WIDTH, SCREEN_HEIGHT};
+    const bool partial = dirtyRegion.collect(screen);
+    const std::vector<SDL_Rect>& dirtyRects = dirtyRegion.getRects();
+    if (partial && dirtyRects.empty()) {
+        return false;
+    }
+    renderStats.repaintedPixels = partial ? static_cast<int>(DirtyRegion::pixelCount(dirtyRects)) : SCREEN_WIDTH * SCREEN_HEIGHT;
+
+    // Все спрайты кадра собираются в один пакет для SDL_RenderGeometry
+    spriteBatch.begin(atlas.getTexture(), atlas.getWidth(), atlas.getHeight());
+    if (!backgroundLayer.isAvailable()) {
+        const SDL_Rect& bgSrc = atlas.getRegion(backgroundSprite);
+        spriteBatch.draw(bgSrc, SDL_FRect{static_cast<float>(backgroundOffset), 0, SCREEN_WIDTH, SCREEN_HEIGHT});
+        spriteBatch.draw(bgSrc, SDL_FRect{static_cast<float>(backgroundOffset + SCREEN_WIDTH), 0, SCREEN_WIDTH, SCREEN_HEIGHT});
     }
-}
 
-void Game::createPipe() {
-    Pipe topPipe, bottomPipe;
+    // Рендеринг труб
+    const SDL_Rect& pipeSrc = atlas.getRegion(pipeSprite);
+    for (int i = 0; i < pipeCount; i++) {
+        spriteBatch.draw(pipeSrc, pipeRects[i]);
+    }
 
-    const int pipeWidth = 60;
-    const int gap = 220;
-    const int minHeight = 100;
-    const int maxHeight = SCREEN_HEIGHT - gap - minHeight - 100;
+    // Призраки прошлых заездов уходят в тот же вызов SDL_RenderGeometry
+    ghosts.draw(spriteBatch, atlas.getRegion(birdSprite), snapshot.ghosts, bird.x, alpha);
 
-    int height = minHeight + (rand() % (maxHeight - minHeight));
+    // Рендеринг птицы
+    spriteBatch.drawRotated(atlas.getRegion(birdSprite), birdRect, birdAngle);
 
-    topPipe.rect.x = SCREEN_WIDTH;
-    topPipe.rect.y = 0;
-    topPipe.rect.w = pipeWidth;
-    topPipe.rect.h = height;
-    topPipe.scored = false;
+    // Рендеринг земли
+    const SDL_Rect& groundArea = groundLayer.getArea();
+    if (!groundLayer.isAvailable()) {
+        const SDL_Rect& groundSrc = atlas.getRegion(groundSprite);
+        spriteBatch.draw(groundSrc, SDL_FRect{static_cast<float>(groundOffset), static_cast<float>(groundArea.y),
+                                              SCREEN_WIDTH, static_cast<float>(groundArea.h)});
+        spriteBatch.draw(groundSrc, SDL_FRect{static_cast<float>(groundOffset + SCREEN_WIDTH), static_cast<float>(groundArea.y),
+                                              SCREEN_WIDTH, static_cast<float>(groundArea.h)});
+    }
 
-    bottomPipe.rect.x = SCREEN_WIDTH;
-    bottomPipe.rect.y = height + gap;
-    bottomPipe.rect.w = pipeWidth;
-    bottomPipe.rect.h = SCREEN_HEIGHT - (height + gap) - 100;
-    bottomPipe.scored = false;
+    // Кадр рисуется целиком или по проходу на каждую область со своим отсечением:
+    // программный рендерер заполняет только пиксели внутри отсечения
+    const size_t passes = partial ? dirtyRects.size() : 1;
+    for (size_t pass = 0; pass < passes; pass++) {
+        if (partial) {
+            SDL_RenderSetClipRect(renderer, &dirtyRects[pass]);
+        }
+        else {
+            SDL_RenderClear(renderer);
+        }
 
-    pipes.push_back(topPipe);
-    pipes.push_back(bottomPipe);
-}
+        // Рендеринг фона
+        if (backgroundLayer.isAvailable()) {
+            backgroundLayer.draw(renderer, backgroundOffset, renderStats);
+        }
+        spriteBatch.end(renderer, renderStats);
+        if (groundLayer.isAvailable()) {
+            groundLayer.draw(renderer, groundOffset, renderStats);
+        }
 
-void Game::updatePipes() {
-    static int framesSinceLastPipe = 0;
-    framesSinceLastPipe++;
+        // Рендеринг UI
+        if (gameState == Simulation::PLAYING) {
+            renderScoreText("Score: ", score, 20, 20);
+        }
+        else {
+            renderMenu(gameState, score, snapshot.summary);
+        }
 
-    if (framesSinceLastPipe >= 180) {
-        createPipe();
-        framesSinceLastPipe = 0;
+        if (snapshot.showProfilerOverlay) {
+            renderProfilerOverlay();
+        }
     }
 
-    for (size_t i = 0; i < pipes.size(); i += 2) {
-        const int pipeSpeed = 2;
-        pipes[i].rect.x -= pipeSpeed;
-        pipes[i + 1].rect.x = pipes[i].rect.x;
+    renderStats.textureUploads = static_cast<int>(textCache.getStats().misses - lastTextMisses);
+    lastTextMisses = textCache.getStats().misses;
+    lastRenderStats = renderStats;
 
-        if (!pipes[i].scored && bird.x > pipes[i].rect.x + pipes[i].rect.w) {
-            score++;
-            pipes[i].scored = true;
-            pipes[i + 1].scored = true;
-            playSound("score");
-        }
+    if (partial) {
+        SDL_RenderSetClipRect(renderer, nullptr);
     }
 
-    while (!pipes.empty() && pipes[0].rect.x + pipes[0].rect.w < 0) {
-        pipes.erase(pipes.begin(), pipes.begin() + 2);
+    PROFILE_SCOPE("present");
+    SDL_RenderPresent(renderer);
+
+    // Каждое нажатие учитывается один раз, на первом показанном кадре с его результатом
+    if (snapshot.inputUs != 0 && snapshot.inputUs != lastPresentedInputUs) {
+        lastPresentedInputUs = snapshot.inputUs;
+        inputLatency.record(Profiler::nowUs() - snapshot.inputUs);
     }
-}
 
-bool Game::checkCollision() {
-    for (const auto& pipe : pipes) {
-        if (SDL_HasIntersection(&bird, &pipe.rect)) {
-            return true;
-        }
+    // Статистика живёт в потоке рендеринга; игровой поток читает её копию
+    RenderReport& report = renderReports.writeBuffer();
+    report.stats = renderStats;
+    report.inputLatency = inputLatency;
+    renderReports.publish();
+
+    if (!startupReported) {
+        startupReported = true;
+        startup.mark("first game frame");
+        startup.finish();
+        startup.report(std::cout);
     }
-    return false;
+    return true;
 }
 
-void Game::render() {
-    SDL_RenderClear(renderer);
-
-    // Рендеринг фона
-    SDL_Rect bgRect = {static_cast<int>(scrollOffset), 0, SCREEN_WIDTH, SCREEN_HEIGHT};
-    SDL_RenderCopy(renderer, backgroundTexture, nullptr, &bgRect);
-    SDL_Rect bgRect2 = {static_cast<int>(scrollOffset) + SCREEN_WIDTH, 0, SCREEN_WIDTH, SCREEN_HEIGHT};
-    SDL_RenderCopy(renderer, backgroundTexture, nullptr, &bgRect2);
-
-    // Рендеринг труб
-    for (const auto& pipe : pipes) {
-        SDL_RenderCopy(renderer, pipeTexture, nullptr, &pipe.rect);
+bool Game::composeLayers() {
+    // Плитки собираются при загрузке и заново после потери текстур-целей
+    bool composed = false;
+    if (backgroundLayer.isAvailable() && !backgroundLayer.isValid()) {
+        composed = backgroundLayer.compose(renderer, atlas.getTexture(), atlas.getRegion(backgroundSprite)) || composed;
+    }
+    if (groundLayer.isAvailable() && !groundLayer.isValid()) {
+        composed = groundLayer.compose(renderer, atlas.getTexture(), atlas.getRegion(groundSprite)) || composed;
     }
+    return composed;
+}
 
-    // Рендеринг птицы
-    SDL_RenderCopyEx(renderer, birdTexture, nullptr, &bird, birdAngle, nullptr, SDL_FLIP_NONE);
+void Game::renderMenu(Simulation::State state, int score, const RunSummary& summary) {
+    const SDL_Rect area = state == Simulation::WAITING
+        ? SDL_Rect{SCREEN_WIDTH / 2 - 300, SCREEN_HEIGHT / 2 - 80, 600, 160}
+        : SDL_Rect{SCREEN_WIDTH / 2 - 300, SCREEN_HEIGHT / 2 - 130, 600, 260};
+    if (!menuCache.isAvailable()) {
+        drawMenuContents(state, score, summary, area);
+        return;
+    }
 
-    // Рендеринг земли
-    SDL_Rect groundRect = {static_cast<int>(scrollOffset), SCREEN_HEIGHT - 100, SCREEN_WIDTH, 100};
-    SDL_RenderCopy(renderer, groundTexture, nullptr, &groundRect);
-    SDL_Rect groundRect2 = {static_cast<int>(scrollOffset) + SCREEN_WIDTH, SCREEN_HEIGHT - 100, SCREEN_WIDTH, 100};
-    SDL_RenderCopy(renderer, groundTexture, nullptr, &groundRect2);
+    // Содержимое меню зависит только от состояния, счёта и итогов забега
+    const uint64_t key = (static_cast<uint64_t>(state) << 62) |
+                         (static_cast<uint64_t>(summary.run & 0x3FFFFFFF) << 32) | static_cast<uint32_t>(score);
+    if (menuCache.begin(renderer, key, area)) {
+        drawMenuContents(state, score, summary, area);
+        menuCache.end(renderer);
+    }
+    menuCache.draw(renderer);
+    renderStats.drawCalls++;
+    renderStats.textureSwitches++;
+}
 
+void Game::drawMenuContents(Simulation::State state, int score, const RunSummary& summary, const SDL_Rect& area) {
     // Определение цветов для текста
     SDL_Color titleColor = {255, 255, 255, 255};
-    SDL_Color scoreColor = {255, 223, 0, 255};
     SDL_Color menuColor = {173, 216, 230, 255};
 
-    // Рендеринг UI
-    if (gameState == WAITING) {
-        SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
-        renderRoundedRect(SCREEN_WIDTH / 2 - 300, SCREEN_HEIGHT / 2 - 80, 600, 160, 20);
+    menuPanel.draw(renderer, area.x, area.y, area.w, area.h);
+    renderStats.drawCalls += Panel::DRAW_CALLS;
+    renderStats.textureSwitches++;
+    if (state == Simulation::WAITING) {
         renderText("Press SPACE to Start", SCREEN_WIDTH / 2 - 180, SCREEN_HEIGHT / 2 - 15, menuColor);
     }
-    else if (gameState == GAME_OVER) {
-        SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
-        renderRoundedRect(SCREEN_WIDTH / 2 - 300, SCREEN_HEIGHT / 2 - 130, 600, 260, 20);
+    else if (summary.record >= 0) {
+        const int x = SCREEN_WIDTH / 2 - 180;
+        renderText("Game Over!", SCREEN_WIDTH / 2 - 120, SCREEN_HEIGHT / 2 - 105, titleColor);
+        renderScoreText("Final Score: ", score, x, SCREEN_HEIGHT / 2 - 55);
+        const int bestEnd = renderScoreText("Best: ", summary.best, x, SCREEN_HEIGHT / 2 - 10);
+        renderScoreText("   Record: ", summary.record, bestEnd, SCREEN_HEIGHT / 2 - 10);
+        const int percentEnd = renderScoreText("Better than ", summary.beatPercent, x, SCREEN_HEIGHT / 2 + 35);
+        renderText("% of runs", percentEnd, SCREEN_HEIGHT / 2 + 35, SCORE_COLOR);
+        renderText("Press SPACE to Try Again", x, SCREEN_HEIGHT / 2 + 80, menuColor);
+    }
+    else {
         renderText("Game Over!", SCREEN_WIDTH / 2 - 120, SCREEN_HEIGHT / 2 - 70, titleColor);
-        renderText("Final Score: " + std::to_string(score), SCREEN_WIDTH / 2 - 120, SCREEN_HEIGHT / 2 - 10, scoreColor);
+        renderScoreText("Final Score: ", score, SCREEN_WIDTH / 2 - 120, SCREEN_HEIGHT / 2 - 10);
         renderText("Press SPACE to Try Again", SCREEN_WIDTH / 2 - 180, SCREEN_HEIGHT / 2 + 50, menuColor);
     }
-
-    if (gameState == PLAYING) {
-        renderText("Score: " + std::to_string(score), 20, 20, scoreColor);
-    }
-
-    SDL_RenderPresent(renderer);
 }
 
-void Game::renderRoundedRect(int x, int y, int w, int h, int radius) {
-    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 100);
-    SDL_Rect rect = {x + radius, y + radius, w - 2 * radius, h - 2 * radius};
-    SDL_RenderFillRect(renderer, &rect);
-
-    SDL_Rect topRect = {x + radius, y, w - 2 * radius, radius};
-    SDL_Rect bottomRect = {x + radius, y + h - radius, w - 2 * radius, radius};
-    SDL_RenderFillRect(renderer, &topRect);
-    SDL_RenderFillRect(renderer, &bottomRect);
-
-    SDL_Rect leftRect = {x, y + radius, radius, h - 2 * radius};
-    SDL_Rect rightRect = {x + w - radius, y + radius, radius, h - 2 * radius};
-    SDL_RenderFillRect(renderer, &leftRect);
-    SDL_RenderFillRect(renderer, &rightRect);
-
-    for(int i = 0; i <= radius; i++) {
-        for(int j = 0; j <= radius; j++) {
-            float distance = sqrt((float)(i * i + j * j));
-            if(distance <= radius) {
-                SDL_RenderDrawPoint(renderer, x + radius - i, y + radius - j);
-                SDL_RenderDrawPoint(renderer, x + w - radius + i - 1, y + radius - j);
-                SDL_RenderDrawPoint(renderer, x + radius - i, y + h - radius + j - 1);
-                SDL_RenderDrawPoint(renderer, x + w - radius + i - 1, y + h - radius + j - 1);
-            }
-        }
+void Game::renderProfilerOverlay() {
+    Profiler& profiler = Profiler::instance();
+    const uint64_t now = Profiler::nowUs();
+
+    if (now - overlayUpdatedUs > 250000) {
+        overlayUpdatedUs = now;
+        char line[96];
+        snprintf(line, sizeof(line), "Frame %.2f ms", profiler.lastFrameMs());
+        overlayLines[0] = line;
+        snprintf(line, sizeof(line), "p50 %.1f  p95 %.1f  p99 %.1f",
+                 profiler.frameMsPercentile(50), profiler.frameMsPercentile(95), profiler.frameMsPercentile(99));
+        overlayLines[1] = line;
+        snprintf(line, sizeof(line), "Draws %d  Tex %d  Uploads %d",
+                 lastRenderStats.drawCalls, lastRenderStats.textureSwitches, lastRenderStats.textureUploads);
+        overlayLines[2] = line;
+        snprintf(line, sizeof(line), "Input p50 %.1f  p95 %.1f ms%s",
+                 inputLatency.percentileMs(50), inputLatency.percentileMs(95), lowLatency ? "  LL" : "");
+        overlayLines[3] = line;
     }
-}
 
-void Game::renderText(const std::string& text, int x, int y, SDL_Color color) {
-    SDL_Surface* surface = TTF_RenderText_Blended(font, text.c_str(), color);
-    if (!surface) {
-        return;
+    const SDL_Color overlayColor = {255, 255, 255, 255};
+    menuPanel.draw(renderer, SCREEN_WIDTH - 450, 10, 440, 156);
+    renderStats.drawCalls += Panel::DRAW_CALLS;
+    renderStats.textureSwitches++;
+    for (int i = 0; i < 4; i++) {
+        renderText(overlayLines[i].c_str(), SCREEN_WIDTH - 435, 18 + i * 36, overlayColor);
     }
+}
 
-    SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
-    if (!texture) {
-        SDL_FreeSurface(surface);
-        return;
+int Game::renderText(const char* text, int x, int y, SDL_Color color) {
+    PROFILE_SCOPE("renderText");
+    const TextCache::Entry* entry = textCache.get(text, color);
+    if (!entry) {
+        return 0;
     }
 
-    SDL_Rect rect = {x, y, surface->w, surface->h};
-    SDL_RenderCopy(renderer, texture, nullptr, &rect);
-
-    SDL_FreeSurface(surface);
-    SDL_DestroyTexture(texture);
+    SDL_Rect rect = {x, y, entry->w, entry->h};
+    SDL_RenderCopy(renderer, entry->texture, nullptr, &rect);
+    renderStats.drawCalls++;
+    renderStats.textureSwitches++;
+    return entry->w;
 }
 
-void Game::jump() {
-    if (gameState == PLAYING) {
-        birdVelocity = std::max(jumpForce, -4.0f);  // Добавили ограничение
-        birdAngle = -25.0f;
-        playSound("jump");
+int Game::renderScoreText(const char* label, int score, int x, int y) {
+    // Подпись и каждая цифра — отдельные записи кэша, поэтому новый счёт
+    // не растеризует новую строку
+    x += renderText(label, x, y, SCORE_COLOR);
+    for (const char* digit = frameArena.format("%d", score); *digit; digit++) {
+        const char glyph[2] = {*digit, '\0'};
+        x += renderText(glyph, x, y, SCORE_COLOR);
     }
+    return x;
 }
 
 bool Game::initAudio() {
-    if (Mix_OpenAudio(44100, MIX_DEFAULT_FORMAT, 2, 2048) < 0) {
-        std::cout << "SDL_mixer initialization failed: " << Mix_GetError() << std::endl;
+    // Открытие устройства бывает долгим, поэтому выполняется в фоновом потоке;
+    // подсистема аудио к этому времени уже инициализирована в главном.
+    // Без звука игра продолжает работать
+    StartupTimer::Scope step(startup, "open audio device");
+    if (Mix_OpenAudio(AssetManifest::AUDIO_FREQUENCY, AssetManifest::AUDIO_SAMPLE_FORMAT,
+                      AssetManifest::AUDIO_CHANNELS, 2048) < 0) {
+        std::cout << "Warning: SDL_mixer initialization failed: " << Mix_GetError() << std::endl;
         return false;
     }
 
     Mix_AllocateChannels(8);
     Mix_Volume(-1, MIX_MAX_VOLUME / 4);  // Громкость эффектов 25%
     Mix_VolumeMusic(0);                  // Выключаем фоновую музыку
-
-    loadAudio();
     return true;
 }
 
-void Game::loadAudio() {
-    audio.backgroundMusic = Mix_LoadMUS("assets/audio/background.mp3");
-    if (!audio.backgroundMusic) {
-        std::cout << "Warning: Failed to load background music: " << Mix_GetError() << std::endl;
-    }
-
-    const std::vector<std::pair<std::string, std::string>> soundFiles = {
-        {"jump", "assets/audio/jump.wav"},
-        {"score", "assets/audio/score.wav"},
-        {"hit", "assets/audio/hit.wav"},
-        {"die", "assets/audio/die.wav"}
-    };
-
-    for (const auto& [name, path] : soundFiles) {
-        Mix_Chunk* sound = Mix_LoadWAV(path.c_str());
-        if (!sound) {
-            std::cout << "Warning: Failed to load sound effect " << name << ": " << Mix_GetError() << std::endl;
-            continue;
-        }
-        audio.soundEffects[name] = sound;
-    }
-
-    setMusicVolume(audio.musicVolume);
-    setSoundVolume(audio.soundVolume);
-}
-
-void Game::playSound(const std::string& name) {
+void Game::playSound(AssetManifest::SoundId sound, uint32_t delayMs) {
     if (!audio.soundEnabled) return;
-
-    auto it = audio.soundEffects.find(name);
-    if (it != audio.soundEffects.end() && it->second) {
-        // Используем конкретный канал для каждого типа звука
-        int channel = -1;
-        if (name == "hit") channel = 0;
-        else if (name == "die") channel = 1;
-        else if (name == "score") channel = 2;
-        else if (name == "jump") channel = 3;
-
-        Mix_PlayChannel(channel, it->second, 0);
-    }
+    audio.effects.play(sound, delayMs);
 }
 
 void Game::playMusic() {
@@ -476,92 +930,119 @@ void Game::setMusicVolume(int volume) {
 
 void Game::setSoundVolume(int volume) {
     audio.soundVolume = std::clamp(volume, 0, MIX_MAX_VOLUME);
-    for (auto& [name, sound] : audio.soundEffects) {
-        if (sound) {
+    for (int i = 0; i < AssetManifest::SOUND_COUNT; i++) {
+        if (Mix_Chunk* sound = audio.effects.getSound(static_cast<AssetManifest::SoundId>(i))) {
             Mix_VolumeChunk(sound, audio.soundVolume);
         }
     }
 }
 
-void Game::resetGame() {
-    pipes.clear();
-    bird.y = SCREEN_HEIGHT / 2;
-    birdVelocity = 0;
-    birdAngle = 0;
-    score = 0;
-    gameState = WAITING;
-    gameTime = 0;
-    gameSpeed = 0.2f;
-    gravity = INITIAL_GRAVITY;
-    jumpForce = INITIAL_JUMP_FORCE;
-    startTime = SDL_GetTicks();
-    accelerationFactor = 0.0f;
+void Game::setLowLatency(bool value, int fps) {
+    lowLatency = value;
+    targetFps = fps;
+}
+
+int Game::getTargetFps() const {
+    if (targetFps > 0) {
+        return targetFps;
+    }
+    SDL_DisplayMode mode;
+    if (window && SDL_GetWindowDisplayMode(window, &mode) == 0 && mode.refresh_rate > 0) {
+        return mode.refresh_rate;
+    }
+    return 60;
+}
+
+void Game::queueFlap() {
+    if (!pendingInput.flap) {
+        pendingPressUs = Profiler::nowUs();
+    }
+    pendingInput.flap = true;
+}
+
+bool Game::addGhost(const Replay& replay) {
+    return ghosts.add(replay);
+}
+
+void Game::clearGhosts() {
+    ghosts.clear();
+    frame.ghosts.clear();
+}
+
+void Game::setSeed(uint64_t value) {
+    seed = value;
+    sim.seed(seed);
+}
+
+void Game::startRecording(const std::string& path) {
+    recordingPath = path;
+    sim.seed(seed);
+    recorder.begin(seed, Simulation::TICKS_PER_SECOND);
+}
+
+void Game::saveRecording() {
+    recorder.finish(sim);
+    if (recorder.getReplay().save(recordingPath)) {
+        std::cout << "Replay saved to " << recordingPath << " (seed " << seed
+                  << ", score " << sim.getScore() << ")" << std::endl;
+    }
 }
 
 void Game::clean() {
-    for (auto& [name, sound] : audio.soundEffects) {
-        if (sound) {
+    stopRenderThread();
+
+    if (recorder.isActive()) {
+        saveRecording();
+    }
+
+    scores.close();
+
+    // Сначала останавливается аудиопоток, который ещё может обращаться к звукам
+    audio.effects.stop();
+    for (int i = 0; i < AssetManifest::SOUND_COUNT; i++) {
+        const AssetManifest::SoundId id = static_cast<AssetManifest::SoundId>(i);
+        if (Mix_Chunk* sound = audio.effects.getSound(id)) {
             Mix_FreeChunk(sound);
-            sound = nullptr;
+            audio.effects.setSound(id, nullptr);
         }
     }
-    audio.soundEffects.clear();
 
     if (audio.backgroundMusic) {
         Mix_FreeMusic(audio.backgroundMusic);
         audio.backgroundMusic = nullptr;
     }
 
-    if (birdTexture) {
-        SDL_DestroyTexture(birdTexture);
-        birdTexture = nullptr;
-    }
-    if (backgroundTexture) {
-        SDL_DestroyTexture(backgroundTexture);
-        backgroundTexture = nullptr;
-    }
-    if (pipeTexture) {
-        SDL_DestroyTexture(pipeTexture);
-        pipeTexture = nullptr;
-    }
-    if (groundTexture) {
-        SDL_DestroyTexture(groundTexture);
-        groundTexture = nullptr;
-    }
-    if (groundTexture) {
-        SDL_DestroyTexture(groundTexture);
-        groundTexture = nullptr;
-    }
+    // В конвейерном режиме поток рендеринга уже уничтожил рендерер сам
+    destroyRenderer();
+
     if (font) {
         TTF_CloseFont(font);
         font = nullptr;
     }
 
-    if (renderer) {
-        SDL_DestroyRenderer(renderer);
-        renderer = nullptr;
-    }
     if (window) {
         SDL_DestroyWindow(window);
         window = nullptr;
     }
 
     Mix_CloseAudio();
+    // Звуки и шрифт ссылались на отображённый архив, поэтому он закрывается последним
+    archive.close();
     Mix_Quit();
     TTF_Quit();
     IMG_Quit();
     SDL_Quit();
 }
 
-void Game::updateDifficulty() {
-    float baseSpeed = 0.2f;             // Уменьшенная базовая скорость
-    float maxSpeed = 0.4f;              // Уменьшенная максимальная скорость
-    float accelerationFactor = gameTime / 240000.0f;  // Замедленное ускорение
-    float speedIncrease = std::cbrt(accelerationFactor) * 0.08f;
+bool Game::isIdle() const {
+    // Ожидается только ввод: состояние не меняется, пока игрок не нажмёт SPACE
+    return sim.getState() == Simulation::GAME_OVER && !pendingInput.flap && !showProfilerOverlay &&
+           !redrawRequested;
+}
 
-    gameSpeed = std::min(baseSpeed + speedIncrease, maxSpeed);
-    gravity = INITIAL_GRAVITY * (1.0f + (gameSpeed - baseSpeed) * 0.02f);
-    jumpForce = INITIAL_JUMP_FORCE * (1.0f + (gameSpeed - baseSpeed) * 0.02f);
+void Game::waitForEvent() {
+    PROFILE_SCOPE("idle");
+    SDL_WaitEventTimeout(nullptr, IDLE_WAIT_MS);
 }
 
 bool Game::isGameRunning() const {
@@ -5,95 +5,264 @@
 #include <SDL_image.h>
 #include <SDL_ttf.h>
 #include <SDL_mixer.h>
+#include <atomic>
+#include <future>
 #include <string>
-#include <map>
+#include <thread>
 #include <vector>
 #include <iostream>
+#include "Simulation.h"
+#include "TextCache.h"
+#include "Panel.h"
+#include "TextureAtlas.h"
+#include "SpriteBatch.h"
+#include "Profiler.h"
+#include "Replay.h"
+#include "AssetArchive.h"
+#include "AssetManifest.h"
+#include "StartupTimer.h"
+#include "AudioQueue.h"
+#include "TripleBuffer.h"
+#include "LatencyHistogram.h"
+#include "FrameLimiter.h"
+#include "MenuCache.h"
+#include "ScrollLayer.h"
+#include "DirtyRegion.h"
+#include "FrameArena.h"
+#include "GhostLayer.h"
+#include "ScoreStore.h"
 
 class Game {
 public:
-    static const int SCREEN_WIDTH = 800;
-    static const int SCREEN_HEIGHT = 600;
-    static const int BIRD_WIDTH = 40;
-    static const int BIRD_HEIGHT = 30;
-    static constexpr float INITIAL_GRAVITY = 0.15f;
-    static constexpr float INITIAL_JUMP_FORCE = -4.0f;
-
-    enum GameState {
-        WAITING,
-        PLAYING,
-        GAME_OVER
-    };
-
-    struct Pipe {
-        SDL_Rect rect;
-        bool scored;
-    };
+    static const int SCREEN_WIDTH = Simulation::SCREEN_WIDTH;
+    static const int SCREEN_HEIGHT = Simulation::SCREEN_HEIGHT;
+    static const int BIRD_WIDTH = Simulation::BIRD_WIDTH;
+    static const int BIRD_HEIGHT = Simulation::BIRD_HEIGHT;
+    static const int IDLE_WAIT_MS = 500;
+    // Скорость слоёв относительно scrollOffset симуляции (1 пиксель за шаг игры,
+    // вдвое медленнее труб): земля идёт с прежней скоростью, фон — вдвое медленнее
+    static constexpr float BACKGROUND_PARALLAX = 0.5f;
+    static constexpr float GROUND_PARALLAX = 1.0f;
+    static constexpr const char* SCORE_LOG_PATH = "scores.log";
 
     struct AudioSystem {
         Mix_Music* backgroundMusic;
-        std::map<std::string, Mix_Chunk*> soundEffects;
+        AudioQueue effects;  // Банк звуков и очередь событий для аудиопотока
         bool musicEnabled;
         bool soundEnabled;
         int musicVolume;
         int soundVolume;
     };
 
+    // Итог последнего забега для экрана конца игры; без таблицы результатов record < 0
+    struct RunSummary {
+        uint32_t run = 0;               // Номер забега в сессии, меняет ключ кэша меню
+        int best = -1;                  // Личный рекорд этого автомата
+        int record = -1;                // Лучший счёт во всей таблице
+        int beatPercent = 0;            // Доля забегов с меньшим счётом, %
+    };
+
+    // Неизменяемый снимок мира для рендеринга: текущий шаг и предыдущий для интерполяции
+    struct FrameSnapshot {
+        Simulation::State state = Simulation::WAITING;
+        int score = 0;
+        Simulation::Rect bird = {};
+        float birdAngle = 0;
+        float scrollOffset = 0;
+        Simulation::PipeRing pipes;
+        float prevBirdY = 0;
+        float prevBirdAngle = 0;
+        float prevScrollOffset = 0;
+        float pipeShift = 0;            // Сдвиг труб за последний шаг
+        bool showProfilerOverlay = false;
+        uint64_t publishedUs = 0;       // Время шага по Profiler::nowUs()
+        uint64_t inputUs = 0;           // Время нажатия, вызвавшего последний взмах
+        std::vector<GhostLayer::Sprite> ghosts;
+        RunSummary summary;
+    };
+
     Game();
     ~Game();
 
     bool init();
     void handleEvents();
     void update();
-    void render();
+    // alpha — доля шага симуляции, прошедшая с последнего update(), для интерполяции.
+    // Возвращает false, если кадр не изменился и рисовать его не понадобилось
+    bool render(float alpha = 1.0f);
+    // Следующий render() перерисует весь кадр, даже если ничего не изменилось
+    void requestRedraw() { redrawRequested = true; }
     void clean();
     bool isGameRunning() const;  // Добавлено объявление функции с const
 
+    // Простой: на экране конца игры ничего не меняется до ввода, поэтому
+    // вместо холостых кадров цикл может спать в waitForEvent()
+    bool isIdle() const;
+    void waitForEvent();
+
+    // Конвейерный режим: рендеринг в отдельном потоке по снимкам, которые публикует
+    // update(). SDL2 не позволяет передать рендерер другому потоку, поэтому при
+    // setPipelined(true) до init() рендерер и текстуры создаёт startRenderThread
+    // в потоке рендеринга, и только этот поток ими пользуется
+    void setPipelined(bool value) { renderOnThread = value; }
+    bool startRenderThread(double tickSeconds);
+    void stopRenderThread();
+    bool isPipelined() const { return renderThread.joinable(); }
+
+    // Режим низкой задержки: без vsync, с точным ограничителем кадров
+    // (fps <= 0 — частота дисплея). Вызывается до init()
+    void setLowLatency(bool value, int fps = 0);
+    bool isLowLatency() const { return lowLatency; }
+    int getTargetFps() const;
+    // Задержка от нажатия SPACE до present первого кадра с его результатом.
+    // Как и getRenderStats, читается из игрового потока: копия, опубликованная
+    // последним нарисованным кадром
+    const LatencyHistogram& getInputLatency() { return latestRenderReport().inputLatency; }
+
+    // Рендеринг в поверхность в памяти вместо окна (для записи видео). Вызывается до init()
+    void setOffscreen(bool value) { offscreen = value; }
+    bool isOffscreen() const { return offscreen; }
+    // Взмах на следующем шаге, как от нажатия SPACE; для воспроизведения записанных входов
+    void queueFlap();
+
+    // Призраки прошлых заездов; добавляются до init() или из игрового потока.
+    // false, если в записи нет взмахов или первый взмах неправдоподобно поздний
+    bool addGhost(const Replay& replay);
+    void clearGhosts();
+    size_t getGhostCount() const { return ghosts.size(); }
+
+    // Таблица результатов (обычно SCORE_LOG_PATH). По умолчанию не ведётся, чтобы
+    // бенчмарки и проверки не писали на диск. Вызывается до init()
+    void setScoreLog(const std::string& path) { scoreLogPath = path; }
+
+    // Начать сессию с заданным seed (по умолчанию — от текущего времени)
+    void setSeed(uint64_t seed);
+    // Записать входы сессии; файл сохраняется в clean()
+    void startRecording(const std::string& path);
+    const RenderStats& getRenderStats() { return latestRenderReport().stats; }
+    const Simulation& getSimulation() const { return sim; }
+    SDL_Renderer* getRenderer() const { return renderer; }
+
 private:
+    StartupTimer startup;
+    bool startupReported;
+    AssetArchive archive;
+
     SDL_Window* window;
     SDL_Renderer* renderer;
-    SDL_Texture* birdTexture;
-    SDL_Texture* backgroundTexture;
-    SDL_Texture* pipeTexture;
-    SDL_Texture* groundTexture;
+    bool offscreen;
+    SDL_Surface* offscreenSurface;
+    TextureAtlas atlas;
+    SpriteBatch spriteBatch;
+    RenderStats renderStats;
+    RenderStats lastRenderStats;
+    uint64_t lastTextMisses;
+    int birdSprite;
+    int backgroundSprite;
+    int pipeSprite;
+    int groundSprite;
     TTF_Font* font;
+    TextCache textCache;
+    Panel menuPanel;
+    MenuCache menuCache;
+    ScrollLayer backgroundLayer;
+    ScrollLayer groundLayer;
 
-    SDL_Rect bird;
-    std::vector<Pipe> pipes;
+    Simulation sim;
+    Simulation::Input pendingInput;
+    uint64_t seed;
+    ReplayRecorder recorder;
+    std::string recordingPath;
+    GhostLayer ghosts;
+    std::string scoreLogPath;
+    ScoreStore scores;
 
     bool isRunning;
-    float birdVelocity;
-    float birdAngle;
-    int score;
-    float scrollOffset;
-    GameState gameState;
-    Uint32 gameTime;
-    float gameSpeed;
-    Uint32 startTime;
-    float accelerationFactor;
-    float gravity;
-    float jumpForce;
+
+    // Снимок последнего шага; в конвейерном режиме передаётся потоку рендеринга
+    FrameSnapshot frame;
+    TripleBuffer<FrameSnapshot> snapshots;
+    bool renderOnThread;             // Рендерер создаётся в потоке рендеринга
+    std::thread renderThread;
+    std::atomic<bool> renderThreadRunning;
+    uint64_t tickUs;
+
+    // Замер задержки ввода
+    bool lowLatency;
+    int targetFps;
+    uint64_t pendingPressUs;
+    uint64_t lastPresentedInputUs;
+    LatencyHistogram inputLatency;
+
+    // Статистика кадра для игрового потока; пишет тот поток, который рисует
+    struct RenderReport {
+        RenderStats stats;
+        LatencyHistogram inputLatency;
+    };
+    TripleBuffer<RenderReport> renderReports;
+    const RenderReport& latestRenderReport() {
+        renderReports.update();
+        return renderReports.readBuffer();
+    }
+
+    // Перерисовка по событию вместо каждого кадра
+    bool lastFrameStatic;
+    bool lastFrameHadGhosts;
+    std::atomic<bool> redrawRequested;
+    std::atomic<bool> renderTargetsLost;
+
+    // Прокрутка слоёв и частичная перерисовка в программном рендерере
+    double scrollDistance;          // Путь мира без заворачивания scrollOffset
+    float lastScrollOffset;
+    int lastBackgroundOffset;
+    int lastGroundOffset;
+    Simulation::State lastDrawnState;
+    int lastDrawnScore;
+    bool softwareRenderer;
+    DirtyRegion dirtyRegion;
+
+    // Временные данные кадра (строки надписей); сбрасывается в начале renderFrame
+    FrameArena frameArena;
+
+    // Оверлей профилировщика (F3); строки обновляются несколько раз в секунду
+    bool showProfilerOverlay;
+    uint64_t overlayUpdatedUs;
+    std::string overlayLines[4];
 
     AudioSystem audio;
 
-    SDL_Texture* loadTexture(const std::string& path);
-    void createPipe();
-    void updatePipes();
-    bool checkCollision();
-    void renderRoundedRect(int x, int y, int w, int h, int radius);
-    void renderText(const std::string& text, int x, int y, SDL_Color color);
-    void jump();
-    void updateDifficulty();
+    // Загрузка из архива, если он открыт, иначе из файлов; безопасны для фоновых потоков
+    SDL_Surface* loadSpriteSurface(const AssetManifest::Sprite& sprite);
+    Mix_Chunk* loadSound(const AssetManifest::Sound& sound);
+    SDL_RWops* openAsset(const char* path);
+    void captureFrame();
+    bool renderFrame(const FrameSnapshot& snapshot, float alpha);
+    bool composeLayers();
+    void renderMenu(Simulation::State state, int score, const RunSummary& summary);
+    void drawMenuContents(Simulation::State state, int score, const RunSummary& summary, const SDL_Rect& area);
+    void renderLoop(std::promise<bool>* ready);
+    // Рендерер с панелью меню и ресурсы, которым нужны шрифт и спрайты; вызываются
+    // в потоке, который будет рисовать. destroyRenderer можно вызывать повторно
+    bool createRenderer();
+    bool createRenderResources();
+    void destroyRenderer();
+    // Возвращает ширину надписи
+    int renderText(const char* text, int x, int y, SDL_Color color);
+    // Возвращает x за последней цифрой
+    int renderScoreText(const char* label, int score, int x, int y);
+    void renderProfilerOverlay();
+    void handleSimEvents(uint32_t events);
+    void recordRun();
+    // Завершает запись сессии и сохраняет её в recordingPath
+    void saveRecording();
     bool initAudio();
-    void loadAudio();
-    void playSound(const std::string& name);
+    void playSound(AssetManifest::SoundId sound, uint32_t delayMs = 0);
     void playMusic();
     void stopMusic();
     void toggleMusic();
     void toggleSound();
     void setMusicVolume(int volume);
     void setSoundVolume(int volume);
-    void resetGame();
 };
 
 #endif // GAME_H
\ No newline at end of file
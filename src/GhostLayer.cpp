@@ -0,0 +1,106 @@
+#include "GhostLayer.h"
+#include <cmath>
+
+namespace {
+
+// Полупрозрачные оттенки, чтобы соседние призраки различались
+const SDL_Color TINTS[] = {
+    {255, 255, 255, 110},
+    {255, 170, 170, 110},
+    {170, 255, 170, 110},
+    {170, 200, 255, 110},
+    {255, 230, 140, 110},
+    {230, 170, 255, 110},
+    {140, 240, 240, 110},
+    {255, 200, 150, 110}
+};
+const size_t TINT_COUNT = sizeof(TINTS) / sizeof(TINTS[0]);
+
+} // namespace
+
+GhostLayer::GhostLayer() :
+    racing(false)
+{
+}
+
+bool GhostLayer::add(const Replay& replay) {
+    // Ожидание до первого взмаха проигрывается шаг за шагом, поэтому его длина
+    // из файла ограничивается до любых шагов
+    if (replay.flapTicks.empty() || replay.flapTicks.front() > MAX_START_TICK) {
+        return false;
+    }
+
+    Ghost ghost;
+    ghost.flapTicks = replay.flapTicks;
+    ghost.next = 0;
+    ghost.tint = static_cast<uint16_t>(ghosts.size() % TINT_COUNT);
+    ghost.active = false;
+
+    // Ожидание до первого взмаха проигрывается один раз при загрузке,
+    // чтобы старт заезда не стоил тысяч шагов на каждого призрака
+    ghost.start.seed(replay.seed);
+    const Simulation::Input idle;
+    while (ghost.start.getTick() + 1 < ghost.flapTicks.front()) {
+        ghost.start.step(idle);
+    }
+    ghosts.push_back(ghost);
+    return true;
+}
+
+void GhostLayer::clear() {
+    ghosts.clear();
+    racing = false;
+}
+
+void GhostLayer::start() {
+    for (auto& ghost : ghosts) {
+        ghost.sim = ghost.start;
+        ghost.next = 0;
+        ghost.active = true;
+    }
+    racing = !ghosts.empty();
+}
+
+void GhostLayer::step(std::vector<Sprite>& out) {
+    out.clear();
+    if (!racing) {
+        return;
+    }
+
+    Simulation::Input input;
+    for (auto& ghost : ghosts) {
+        if (!ghost.active) {
+            continue;
+        }
+        const Simulation& sim = ghost.sim;
+        const int16_t prevY = static_cast<int16_t>(sim.getBird().y);
+        const int8_t prevAngle = static_cast<int8_t>(std::lround(sim.getBirdAngle()));
+
+        input.flap = ghost.next < ghost.flapTicks.size() && ghost.flapTicks[ghost.next] == sim.getTick() + 1;
+        if (input.flap) {
+            ghost.next++;
+        }
+        ghost.sim.step(input);
+
+        // Проигрыш завершает заезд призрака; рестарт из записи уже не в счёт
+        if (sim.getState() != Simulation::PLAYING) {
+            ghost.active = false;
+            continue;
+        }
+        out.push_back(Sprite{static_cast<int16_t>(sim.getBird().y), prevY,
+                             static_cast<int8_t>(std::lround(sim.getBirdAngle())), prevAngle, ghost.tint});
+    }
+}
+
+void GhostLayer::draw(SpriteBatch& batch, const SDL_Rect& src, const std::vector<Sprite>& sprites, int birdX, float alpha) {
+    const float w = Simulation::BIRD_WIDTH * SCALE;
+    const float h = Simulation::BIRD_HEIGHT * SCALE;
+    const float x = birdX + (Simulation::BIRD_WIDTH - w) * 0.5f;
+    const float dy = (Simulation::BIRD_HEIGHT - h) * 0.5f;
+    for (const Sprite& sprite : sprites) {
+        const int y = static_cast<int>(std::lround(sprite.prevY + (sprite.y - sprite.prevY) * alpha));
+        const int angle = static_cast<int>(std::lround(sprite.prevAngle + (sprite.angle - sprite.prevAngle) * alpha));
+
+        batch.drawRotated(src, SDL_FRect{x, y + dy, w, h}, angle, TINTS[sprite.tint % TINT_COUNT]);
+    }
+}
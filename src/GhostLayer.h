@@ -0,0 +1,61 @@
+#ifndef GHOST_LAYER_H
+#define GHOST_LAYER_H
+
+#include <SDL.h>
+#include <cstdint>
+#include <vector>
+#include "Simulation.h"
+#include "Replay.h"
+#include "SpriteBatch.h"
+
+// Призраки прошлых заездов поверх живой игры. Каждый призрак — своя Simulation,
+// которая повторяет взмахи из записи на своей трассе. Заезд стартует вместе
+// с первым взмахом игрока и для каждого призрака идёт до его первого проигрыша.
+// start/stop/step вызывает игровой поток, draw — поток рендеринга; общие у них
+// только спрайты, которые передаются через снимок кадра.
+class GhostLayer {
+public:
+    static constexpr float SCALE = 0.6f;     // Призраки мельче живой птицы
+    // Первый взмах позже двух минут ожидания — запись испорчена или подделана
+    static const uint64_t MAX_START_TICK = 2 * 60 * Simulation::TICKS_PER_SECOND;
+
+    // Положение призрака в текущем и предыдущем шаге, 8 байт для снимка кадра
+    struct Sprite {
+        int16_t y;
+        int16_t prevY;
+        int8_t angle;
+        int8_t prevAngle;
+        uint16_t tint;
+    };
+
+    GhostLayer();
+
+    // false, если в записи нет ни одного взмаха или первый взмах позже MAX_START_TICK
+    bool add(const Replay& replay);
+    void clear();
+    size_t size() const { return ghosts.size(); }
+
+    void start();
+    void stop() { racing = false; }
+    bool isRacing() const { return racing; }
+    // Шаг всех живых призраков; их спрайты заменяют содержимое out
+    void step(std::vector<Sprite>& out);
+
+    // Добавляет квадраты призраков в пакет кадра, по одному на каждый живой призрак
+    void draw(SpriteBatch& batch, const SDL_Rect& src, const std::vector<Sprite>& sprites, int birdX, float alpha);
+
+private:
+    struct Ghost {
+        Simulation start;           // Состояние перед первым взмахом
+        Simulation sim;
+        std::vector<uint64_t> flapTicks;
+        size_t next;
+        uint16_t tint;
+        bool active;
+    };
+
+    std::vector<Ghost> ghosts;
+    bool racing;
+};
+
+#endif // GHOST_LAYER_H
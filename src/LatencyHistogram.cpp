@@ -0,0 +1,49 @@
+#include "LatencyHistogram.h"
+#include <algorithm>
+#include <cmath>
+
+LatencyHistogram::LatencyHistogram() {
+    clear();
+}
+
+void LatencyHistogram::record(uint64_t us) {
+    buckets[std::min<uint64_t>(us / BUCKET_US, BUCKETS - 1)]++;
+    total++;
+    sumUs += us;
+    maxUs = std::max(maxUs, us);
+}
+
+void LatencyHistogram::clear() {
+    buckets.fill(0);
+    total = 0;
+    sumUs = 0;
+    maxUs = 0;
+}
+
+double LatencyHistogram::meanMs() const {
+    return total ? static_cast<double>(sumUs) / total / 1000.0 : 0.0;
+}
+
+double LatencyHistogram::percentileMs(double p) const {
+    if (total == 0) {
+        return 0.0;
+    }
+    const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(total * std::clamp(p, 0.0, 100.0) / 100.0)));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < BUCKETS; i++) {
+        seen += buckets[i];
+        if (seen >= rank) {
+            return std::min((i + 1) * BUCKET_US, maxUs) / 1000.0;
+        }
+    }
+    return maxMs();
+}
+
+void LatencyHistogram::report(std::ostream& out, const char* name) const {
+    out << name << ": " << total << " samples";
+    if (total) {
+        out << ", mean " << meanMs() << " ms, p50 " << percentileMs(50) << " ms, p95 " << percentileMs(95)
+            << " ms, p99 " << percentileMs(99) << " ms, max " << maxMs() << " ms";
+    }
+    out << std::endl;
+}
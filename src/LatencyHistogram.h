@@ -0,0 +1,35 @@
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+#include <array>
+#include <cstdint>
+#include <ostream>
+
+// Гистограмма задержек с корзинами по BUCKET_US; всё, что дольше
+// BUCKETS * BUCKET_US, попадает в последнюю корзину
+class LatencyHistogram {
+public:
+    static const uint64_t BUCKET_US = 250;
+    static const size_t BUCKETS = 800;  // До 200 мс
+
+    LatencyHistogram();
+
+    void record(uint64_t us);
+    void clear();
+
+    uint64_t count() const { return total; }
+    double meanMs() const;
+    double maxMs() const { return maxUs / 1000.0; }
+    // p в диапазоне [0, 100]; верхняя граница корзины, в которую попал перцентиль
+    double percentileMs(double p) const;
+
+    void report(std::ostream& out, const char* name) const;
+
+private:
+    std::array<uint32_t, BUCKETS> buckets;
+    uint64_t total;
+    uint64_t sumUs;
+    uint64_t maxUs;
+};
+
+#endif // LATENCY_HISTOGRAM_H
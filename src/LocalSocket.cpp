@@ -0,0 +1,200 @@
+#include "LocalSocket.h"
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <utility>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <winsock2.h>
+#include <afunix.h>
+#ifndef IO_REPARSE_TAG_AF_UNIX
+#define IO_REPARSE_TAG_AF_UNIX 0x80000023L
+#endif
+using NativeSocket = SOCKET;
+using SocketLength = int;
+#else
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+using NativeSocket = int;
+using SocketLength = socklen_t;
+#endif
+
+namespace {
+
+#ifdef MSG_NOSIGNAL
+const int SEND_FLAGS = MSG_NOSIGNAL;    // Разрыв соединения — ошибка send, а не SIGPIPE
+#else
+const int SEND_FLAGS = 0;
+#endif
+
+bool makeAddress(const std::string& path, sockaddr_un& address) {
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(address.sun_path)) {
+        std::cout << "Socket path is too long: " << path << std::endl;
+        return false;
+    }
+    memcpy(address.sun_path, path.c_str(), path.size() + 1);
+    return true;
+}
+
+// Сокет, оставшийся от прошлого запуска, удаляется перед bind. Любой другой файл
+// по этому пути — скорее всего опечатка в аргументе, и он не трогается
+bool removeStaleSocket(const std::string& path) {
+#ifdef _WIN32
+    // Файл сокета AF_UNIX в Windows — точка повторной обработки с особым тегом
+    WIN32_FIND_DATAA data;
+    HANDLE find = FindFirstFileA(path.c_str(), &data);
+    if (find == INVALID_HANDLE_VALUE) {
+        return true;
+    }
+    FindClose(find);
+    const bool isSocket = (data.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT) &&
+                          data.dwReserved0 == IO_REPARSE_TAG_AF_UNIX;
+    if (isSocket && DeleteFileA(path.c_str())) {
+        return true;
+    }
+#else
+    struct stat info;
+    if (lstat(path.c_str(), &info) != 0) {
+        return true;
+    }
+    const bool isSocket = S_ISSOCK(info.st_mode);
+    if (isSocket && unlink(path.c_str()) == 0) {
+        return true;
+    }
+#endif
+    if (isSocket) {
+        std::cout << "Failed to remove the stale socket " << path << std::endl;
+    }
+    else {
+        std::cout << path << " exists and is not a socket; refusing to replace it" << std::endl;
+    }
+    return false;
+}
+
+} // namespace
+
+LocalSocket::LocalSocket(LocalSocket&& other) noexcept :
+    handle(other.handle),
+    boundPath(std::move(other.boundPath))
+{
+    other.handle = INVALID;
+    other.boundPath.clear();
+}
+
+LocalSocket& LocalSocket::operator=(LocalSocket&& other) noexcept {
+    if (this != &other) {
+        close();
+        handle = other.handle;
+        boundPath = std::move(other.boundPath);
+        other.handle = INVALID;
+        other.boundPath.clear();
+    }
+    return *this;
+}
+
+bool LocalSocket::create() {
+    close();
+#ifdef _WIN32
+    static const bool started = [] {
+        WSADATA data;
+        return WSAStartup(MAKEWORD(2, 2), &data) == 0;
+    }();
+    if (!started) {
+        std::cout << "WSAStartup failed" << std::endl;
+        return false;
+    }
+    const SOCKET value = socket(AF_UNIX, SOCK_STREAM, 0);
+    handle = value == INVALID_SOCKET ? INVALID : static_cast<intptr_t>(value);
+#else
+    handle = socket(AF_UNIX, SOCK_STREAM, 0);
+#endif
+    if (handle == INVALID) {
+        std::cout << "Failed to create a local socket" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool LocalSocket::listen(const std::string& path) {
+    sockaddr_un address;
+    if (!makeAddress(path, address) || !removeStaleSocket(path) || !create()) {
+        return false;
+    }
+    if (bind(static_cast<NativeSocket>(handle), reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 ||
+        ::listen(static_cast<NativeSocket>(handle), 1) != 0) {
+        std::cout << "Failed to listen on " << path << std::endl;
+        close();
+        return false;
+    }
+    boundPath = path;
+    return true;
+}
+
+LocalSocket LocalSocket::accept() {
+#ifdef _WIN32
+    const SOCKET client = ::accept(static_cast<NativeSocket>(handle), nullptr, nullptr);
+    return LocalSocket(client == INVALID_SOCKET ? INVALID : static_cast<intptr_t>(client));
+#else
+    return LocalSocket(::accept(static_cast<NativeSocket>(handle), nullptr, nullptr));
+#endif
+}
+
+bool LocalSocket::connect(const std::string& path) {
+    sockaddr_un address;
+    if (!makeAddress(path, address) || !create()) {
+        return false;
+    }
+    if (::connect(static_cast<NativeSocket>(handle), reinterpret_cast<const sockaddr*>(&address),
+                  static_cast<SocketLength>(sizeof(address))) != 0) {
+        std::cout << "Failed to connect to " << path << std::endl;
+        close();
+        return false;
+    }
+    return true;
+}
+
+void LocalSocket::close() {
+    if (handle != INVALID) {
+#ifdef _WIN32
+        closesocket(static_cast<NativeSocket>(handle));
+#else
+        ::close(static_cast<NativeSocket>(handle));
+#endif
+        handle = INVALID;
+    }
+    if (!boundPath.empty()) {
+        remove(boundPath.c_str());
+        boundPath.clear();
+    }
+}
+
+bool LocalSocket::sendAll(const void* data, size_t size) {
+    const char* bytes = static_cast<const char*>(data);
+    while (size > 0) {
+        const auto sent = send(static_cast<NativeSocket>(handle), bytes, static_cast<int>(size), SEND_FLAGS);
+        if (sent <= 0) {
+            return false;
+        }
+        bytes += sent;
+        size -= static_cast<size_t>(sent);
+    }
+    return true;
+}
+
+bool LocalSocket::receiveAll(void* data, size_t size) {
+    char* bytes = static_cast<char*>(data);
+    while (size > 0) {
+        const auto received = recv(static_cast<NativeSocket>(handle), bytes, static_cast<int>(size), 0);
+        if (received <= 0) {
+            return false;
+        }
+        bytes += received;
+        size -= static_cast<size_t>(received);
+    }
+    return true;
+}
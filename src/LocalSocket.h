@@ -0,0 +1,42 @@
+#ifndef LOCAL_SOCKET_H
+#define LOCAL_SOCKET_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Потоковый сокет Unix (AF_UNIX) для связи процессов на одном компьютере.
+// На Windows — AF_UNIX из Winsock (Windows 10 1803 и новее)
+class LocalSocket {
+public:
+    LocalSocket() : handle(INVALID) {}
+    ~LocalSocket() { close(); }
+
+    LocalSocket(LocalSocket&& other) noexcept;
+    LocalSocket& operator=(LocalSocket&& other) noexcept;
+    LocalSocket(const LocalSocket&) = delete;
+    LocalSocket& operator=(const LocalSocket&) = delete;
+
+    // Старый файл сокета по этому пути удаляется; если там другой файл — ошибка
+    bool listen(const std::string& path);
+    // Блокирует до подключения клиента; невалидный сокет — ошибка
+    LocalSocket accept();
+    bool connect(const std::string& path);
+    void close();
+    bool isValid() const { return handle != INVALID; }
+
+    // false — соединение закрыто или ошибка
+    bool sendAll(const void* data, size_t size);
+    bool receiveAll(void* data, size_t size);
+
+private:
+    static const intptr_t INVALID = -1;
+
+    intptr_t handle;
+    std::string boundPath;      // Файл сокета, который удаляется при закрытии
+
+    explicit LocalSocket(intptr_t value) : handle(value) {}
+    bool create();
+};
+
+#endif // LOCAL_SOCKET_H
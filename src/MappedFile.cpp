@@ -0,0 +1,114 @@
+#include "MappedFile.h"
+#include <cstdio>
+#include <iostream>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile() :
+    mapping(nullptr),
+    mappedSize(0),
+    fileHandle(nullptr),
+    mappingHandle(nullptr)
+{
+}
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+bool MappedFile::create(const std::string& path, size_t size, bool removeOnClose) {
+    if (!map(path, size, true)) {
+        return false;
+    }
+    if (removeOnClose) {
+        ownedPath = path;
+    }
+    return true;
+}
+
+bool MappedFile::open(const std::string& path) {
+    return map(path, 0, false);
+}
+
+bool MappedFile::map(const std::string& path, size_t size, bool create) {
+    close();
+#ifdef _WIN32
+    // Другие процессы должны иметь возможность писать в тот же файл
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE,
+                              nullptr, create ? CREATE_ALWAYS : OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    LARGE_INTEGER fileSize;
+    if (file == INVALID_HANDLE_VALUE || (!create && !GetFileSizeEx(file, &fileSize))) {
+        std::cout << "Failed to open " << path << std::endl;
+        if (file != INVALID_HANDLE_VALUE) {
+            CloseHandle(file);
+        }
+        return false;
+    }
+    if (!create) {
+        size = static_cast<size_t>(fileSize.QuadPart);
+    }
+    // Отображение нужного размера само дополняет новый файл нулями
+    const unsigned long long size64 = size;
+    HANDLE view = size ? CreateFileMappingA(file, nullptr, PAGE_READWRITE, static_cast<DWORD>(size64 >> 32),
+                                            static_cast<DWORD>(size64), nullptr) : nullptr;
+    void* data = view ? MapViewOfFile(view, FILE_MAP_WRITE, 0, 0, size) : nullptr;
+    if (!data) {
+        std::cout << "Failed to map " << path << std::endl;
+        if (view) {
+            CloseHandle(view);
+        }
+        CloseHandle(file);
+        return false;
+    }
+    fileHandle = file;
+    mappingHandle = view;
+#else
+    const int fd = ::open(path.c_str(), create ? O_RDWR | O_CREAT | O_TRUNC : O_RDWR, 0644);
+    struct stat info;
+    if (fd < 0 || (create && ftruncate(fd, static_cast<off_t>(size)) != 0) || fstat(fd, &info) != 0) {
+        std::cout << "Failed to open " << path << std::endl;
+        if (fd >= 0) {
+            ::close(fd);
+        }
+        return false;
+    }
+    size = static_cast<size_t>(info.st_size);
+    void* data = size ? mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) : MAP_FAILED;
+    ::close(fd);
+    if (data == MAP_FAILED) {
+        std::cout << "Failed to map " << path << std::endl;
+        return false;
+    }
+#endif
+    mapping = data;
+    mappedSize = size;
+    return true;
+}
+
+void MappedFile::close() {
+    if (mapping) {
+#ifdef _WIN32
+        UnmapViewOfFile(mapping);
+        CloseHandle(static_cast<HANDLE>(mappingHandle));
+        CloseHandle(static_cast<HANDLE>(fileHandle));
+        mappingHandle = nullptr;
+        fileHandle = nullptr;
+#else
+        munmap(mapping, mappedSize);
+#endif
+        mapping = nullptr;
+        mappedSize = 0;
+    }
+    if (!ownedPath.empty()) {
+        remove(ownedPath.c_str());
+        ownedPath.clear();
+    }
+}
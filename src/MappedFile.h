@@ -0,0 +1,37 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <string>
+
+// Файл, отображённый в память на чтение и запись (MAP_SHARED): изменения сразу
+// видны другим процессам, отобразившим тот же файл
+class MappedFile {
+public:
+    MappedFile();
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Создаёт файл заданного размера, заполненный нулями; removeOnClose — удалить его в close()
+    bool create(const std::string& path, size_t size, bool removeOnClose = true);
+    // Отображает существующий файл целиком
+    bool open(const std::string& path);
+    void close();
+
+    void* data() const { return mapping; }
+    size_t size() const { return mappedSize; }
+    bool isOpen() const { return mapping != nullptr; }
+
+private:
+    void* mapping;
+    size_t mappedSize;
+    void* fileHandle;
+    void* mappingHandle;
+    std::string ownedPath;
+
+    bool map(const std::string& path, size_t size, bool create);
+};
+
+#endif // MAPPED_FILE_H
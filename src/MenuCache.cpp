@@ -0,0 +1,70 @@
+#include "MenuCache.h"
+#include <iostream>
+
+MenuCache::MenuCache() :
+    texture(nullptr),
+    area{0, 0, 0, 0},
+    key(0),
+    valid(false)
+{
+}
+
+MenuCache::~MenuCache() {
+    destroy();
+}
+
+bool MenuCache::create(SDL_Renderer* renderer, int width, int height) {
+    destroy();
+    if (!SDL_RenderTargetSupported(renderer)) {
+        return false;
+    }
+    texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET, width, height);
+    if (!texture) {
+        std::cout << "Failed to create menu cache texture: " << SDL_GetError() << std::endl;
+        return false;
+    }
+
+    // Текстура уже содержит цвет, умноженный на альфу
+    const SDL_BlendMode premultiplied = SDL_ComposeCustomBlendMode(
+        SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD,
+        SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD);
+    if (SDL_SetTextureBlendMode(texture, premultiplied) < 0) {
+        SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+    }
+    return true;
+}
+
+void MenuCache::destroy() {
+    if (texture) {
+        SDL_DestroyTexture(texture);
+        texture = nullptr;
+    }
+    valid = false;
+}
+
+bool MenuCache::begin(SDL_Renderer* renderer, uint64_t newKey, const SDL_Rect& newArea) {
+    if (valid && key == newKey) {
+        return false;
+    }
+    if (SDL_SetRenderTarget(renderer, texture) < 0) {
+        return false;
+    }
+
+    key = newKey;
+    area = newArea;
+    Uint8 r, g, b, a;
+    SDL_GetRenderDrawColor(renderer, &r, &g, &b, &a);
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
+    SDL_RenderClear(renderer);
+    SDL_SetRenderDrawColor(renderer, r, g, b, a);
+    return true;
+}
+
+void MenuCache::end(SDL_Renderer* renderer) {
+    SDL_SetRenderTarget(renderer, nullptr);
+    valid = true;
+}
+
+void MenuCache::draw(SDL_Renderer* renderer) const {
+    SDL_RenderCopy(renderer, texture, &area, &area);
+}
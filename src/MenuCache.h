@@ -0,0 +1,37 @@
+#ifndef MENU_CACHE_H
+#define MENU_CACHE_H
+
+#include <SDL.h>
+#include <cstdint>
+
+// Кэш статичного меню (панель и надписи) в текстуре-цели размером с экран.
+// Меню рисуется в текстуру в тех же экранных координатах только при смене
+// ключа, а в кадр копируется один прямоугольник. Содержимое хранится
+// с предумноженной альфой, поэтому при копировании результат тот же,
+// что и при прямом рисовании.
+class MenuCache {
+public:
+    MenuCache();
+    ~MenuCache();
+
+    // false, если рендерер не поддерживает текстуры-цели: тогда меню рисуется напрямую
+    bool create(SDL_Renderer* renderer, int width, int height);
+    void destroy();
+    bool isAvailable() const { return texture != nullptr; }
+
+    // Переключает рендеринг в кэш и возвращает true, если для key его нужно перерисовать.
+    // После перерисовки обязателен end()
+    bool begin(SDL_Renderer* renderer, uint64_t key, const SDL_Rect& area);
+    void end(SDL_Renderer* renderer);
+    void draw(SDL_Renderer* renderer) const;
+    // Содержимое текстур-целей теряется при сбросе устройства
+    void invalidate() { valid = false; }
+
+private:
+    SDL_Texture* texture;
+    SDL_Rect area;
+    uint64_t key;
+    bool valid;
+};
+
+#endif // MENU_CACHE_H
@@ -0,0 +1,231 @@
+#include "ObservationRasterizer.h"
+#include <algorithm>
+#include <cstring>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define OBSERVATION_RASTERIZER_X86 1
+#endif
+
+namespace {
+
+// Скалярное ядро: memset/memcpy из стандартной библиотеки
+void fillScalar(uint8_t* dst, int count, uint8_t shade) {
+    memset(dst, shade, static_cast<size_t>(count));
+}
+
+void replicateScalar(const uint8_t* row, uint8_t* dst, int width, int rows, int stride) {
+    for (int r = 0; r < rows; r++, dst += stride) {
+        memcpy(dst, row, static_cast<size_t>(width));
+    }
+}
+
+#ifdef OBSERVATION_RASTERIZER_X86
+
+// Хвост короче вектора дописывается последней записью, перекрывающей предыдущую:
+// ширина кадра произвольная, а скалярного хвоста нет
+__attribute__((target("sse2")))
+void fillSse2(uint8_t* dst, int count, uint8_t shade) {
+    if (count < 16) {
+        memset(dst, shade, static_cast<size_t>(count));
+        return;
+    }
+    const __m128i value = _mm_set1_epi8(static_cast<char>(shade));
+    for (int x = 0; x + 16 <= count; x += 16) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x), value);
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + count - 16), value);
+}
+
+__attribute__((target("sse2")))
+void replicateSse2(const uint8_t* row, uint8_t* dst, int width, int rows, int stride) {
+    if (width < 16) {
+        replicateScalar(row, dst, width, rows, stride);
+        return;
+    }
+    for (int r = 0; r < rows; r++, dst += stride) {
+        for (int x = 0; x + 16 <= width; x += 16) {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x),
+                             _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + x)));
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + width - 16),
+                         _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + width - 16)));
+    }
+}
+
+__attribute__((target("avx2")))
+void fillAvx2(uint8_t* dst, int count, uint8_t shade) {
+    if (count < 32) {
+        fillSse2(dst, count, shade);
+        return;
+    }
+    const __m256i value = _mm256_set1_epi8(static_cast<char>(shade));
+    for (int x = 0; x + 32 <= count; x += 32) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + x), value);
+    }
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + count - 32), value);
+}
+
+__attribute__((target("avx2")))
+void replicateAvx2(const uint8_t* row, uint8_t* dst, int width, int rows, int stride) {
+    if (width < 32) {
+        replicateSse2(row, dst, width, rows, stride);
+        return;
+    }
+    for (int r = 0; r < rows; r++, dst += stride) {
+        for (int x = 0; x + 32 <= width; x += 32) {
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + x),
+                                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + x)));
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + width - 32),
+                            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + width - 32)));
+    }
+}
+
+#endif
+
+} // namespace
+
+ObservationRasterizer::ObservationRasterizer(int frameWidth, int frameHeight) :
+    width(std::min(std::max(frameWidth, 1), MAX_SIZE)),
+    height(std::min(std::max(frameHeight, 1), MAX_SIZE)),
+    groundRow(0),
+    kernel(KERNEL_SCALAR),
+    fill(fillScalar),
+    replicate(replicateScalar)
+{
+    int last = 0;
+    pixelRange(Simulation::SCREEN_HEIGHT - Simulation::GROUND_HEIGHT, Simulation::SCREEN_HEIGHT,
+               Simulation::SCREEN_HEIGHT, height, height, groundRow, last);
+    setKernel(bestKernel());
+}
+
+ObservationRasterizer::Kernel ObservationRasterizer::bestKernel() {
+#ifdef OBSERVATION_RASTERIZER_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return KERNEL_AVX2;
+    }
+    if (__builtin_cpu_supports("sse2")) {
+        return KERNEL_SSE2;
+    }
+#endif
+    return KERNEL_SCALAR;
+}
+
+const char* ObservationRasterizer::kernelName(Kernel kernel) {
+    switch (kernel) {
+        case KERNEL_AVX2: return "avx2";
+        case KERNEL_SSE2: return "sse2";
+        default: return "scalar";
+    }
+}
+
+void ObservationRasterizer::setKernel(Kernel value) {
+    kernel = std::min(value, bestKernel());
+    fill = fillScalar;
+    replicate = replicateScalar;
+#ifdef OBSERVATION_RASTERIZER_X86
+    if (kernel == KERNEL_AVX2) {
+        fill = fillAvx2;
+        replicate = replicateAvx2;
+    }
+    else if (kernel == KERNEL_SSE2) {
+        fill = fillSse2;
+        replicate = replicateSse2;
+    }
+#endif
+}
+
+void ObservationRasterizer::pixelRange(int from, int to, int screen, int size, int limit, int& first, int& last) {
+    // Центр пикселя c на экране — (2c + 1) * screen / (2 * size); он не меньше from,
+    // если c >= (2 * from * size - screen) / (2 * screen)
+    auto firstAtOrAfter = [screen, size](int coordinate) {
+        const long long numerator = 2LL * coordinate * size - screen;
+        const long long denominator = 2LL * screen;
+        const long long quotient = numerator / denominator;
+        return static_cast<int>(quotient + (numerator > quotient * denominator ? 1 : 0));
+    };
+    first = std::min(std::max(firstAtOrAfter(from), 0), limit);
+    last = std::min(std::max(firstAtOrAfter(to), first), limit);
+}
+
+void ObservationRasterizer::render(const Simulation& sim, uint8_t* frame) const {
+    render(sim.getBird(), sim.getPipes(), frame);
+}
+
+void ObservationRasterizer::render(const Simulation::Rect& bird, const Simulation::PipeRing& pipes,
+                                   uint8_t* frame) const {
+    // Колонки труб и строки, на которых меняется содержимое строки кадра
+    struct Column {
+        int first, last;            // Столбцы пикселей
+        int topEnd;                 // Верхняя труба — строки [0, topEnd)
+        int bottomFirst, bottomEnd; // Нижняя — [bottomFirst, bottomEnd)
+    };
+    Column columns[Simulation::MAX_PIPES];
+    int columnCount = 0;
+    int breaks[Simulation::MAX_PIPES * 3 + 3] = {0, groundRow, height};
+    int breakCount = 3;
+
+    const int groundTop = Simulation::SCREEN_HEIGHT - Simulation::GROUND_HEIGHT;
+    for (const auto& pipe : pipes) {
+        Column column;
+        pixelRange(pipe.x, pipe.x + Simulation::PIPE_WIDTH, Simulation::SCREEN_WIDTH, width, width,
+                   column.first, column.last);
+        if (column.first == column.last) {
+            continue;
+        }
+        int unused = 0;
+        pixelRange(0, pipe.gapTop, Simulation::SCREEN_HEIGHT, height, groundRow, unused, column.topEnd);
+        pixelRange(pipe.gapTop + pipe.gapHeight, groundTop, Simulation::SCREEN_HEIGHT, height, groundRow,
+                   column.bottomFirst, column.bottomEnd);
+        columns[columnCount++] = column;
+        breaks[breakCount++] = column.topEnd;
+        breaks[breakCount++] = column.bottomFirst;
+        breaks[breakCount++] = column.bottomEnd;
+    }
+    std::sort(breaks, breaks + breakCount);
+    breakCount = static_cast<int>(std::unique(breaks, breaks + breakCount) - breaks);
+
+    // Полоса строк между соседними границами: первая строка рисуется, остальные копируются
+    for (int i = 0; i + 1 < breakCount; i++) {
+        const int first = breaks[i];
+        const int last = breaks[i + 1];
+        uint8_t* row = frame + static_cast<size_t>(first) * width;
+        if (first >= groundRow) {
+            fill(row, width, GROUND_SHADE);
+        }
+        else {
+            fill(row, width, SKY_SHADE);
+            for (int c = 0; c < columnCount; c++) {
+                const Column& column = columns[c];
+                if (first < column.topEnd || (first >= column.bottomFirst && first < column.bottomEnd)) {
+                    fill(row + column.first, column.last - column.first, PIPE_SHADE);
+                }
+            }
+        }
+        replicate(row, row + width, width, last - first - 1, width);
+    }
+
+    int left = 0, right = 0, top = 0, bottom = 0;
+    pixelRange(bird.x, bird.x + bird.w, Simulation::SCREEN_WIDTH, width, width, left, right);
+    pixelRange(bird.y, bird.y + bird.h, Simulation::SCREEN_HEIGHT, height, height, top, bottom);
+    for (int y = top; y < bottom && left < right; y++) {
+        fill(frame + static_cast<size_t>(y) * width + left, right - left, BIRD_SHADE);
+    }
+}
+
+void ObservationRasterizer::renderStacked(const Simulation& sim, const uint8_t* previous, uint8_t* stack,
+                                          int depth) const {
+    const size_t bytes = frameBytes();
+    depth = std::max(depth, 1);
+    if (previous) {
+        memmove(stack, previous + bytes, (depth - 1) * bytes);
+        render(sim, stack + (depth - 1) * bytes);
+        return;
+    }
+    render(sim, stack);
+    for (int i = 1; i < depth; i++) {
+        memcpy(stack + i * bytes, stack, bytes);
+    }
+}
@@ -0,0 +1,68 @@
+#ifndef OBSERVATION_RASTERIZER_H
+#define OBSERVATION_RASTERIZER_H
+
+#include "Simulation.h"
+#include <cstddef>
+#include <cstdint>
+
+// Кадр для агентов с "зрением": мир рисуется сразу в маленький буфер
+// width x height по байту на пиксель (оттенки серого), без SDL.
+// Птица — прямоугольник без поворота, трубы и земля — прямоугольники.
+// Пиксель закрашивается, если его центр попадает в прямоугольник на экране 800x600.
+//
+// Строки кадра между границами труб одинаковы, поэтому рисуется только первая
+// строка каждой полосы, а остальные копируются из неё векторными записями.
+class ObservationRasterizer {
+public:
+    static const int MAX_SIZE = 1024;
+    static const uint8_t SKY_SHADE = 0;
+    static const uint8_t PIPE_SHADE = 96;
+    static const uint8_t GROUND_SHADE = 160;
+    static const uint8_t BIRD_SHADE = 255;
+
+    enum Kernel {
+        KERNEL_SCALAR,
+        KERNEL_SSE2,
+        KERNEL_AVX2
+    };
+
+    // Размеры ограничиваются диапазоном [1, MAX_SIZE]
+    ObservationRasterizer(int width, int height);
+
+    void render(const Simulation& sim, uint8_t* frame) const;
+    void render(const Simulation::Rect& bird, const Simulation::PipeRing& pipes, uint8_t* frame) const;
+
+    // Стопка из depth кадров, от старого к новому. Кадры previous[1..depth) сдвигаются
+    // в stack[0..depth - 1), новый рисуется последним; previous может совпадать со stack.
+    // Без previous (начало эпизода) новым кадром заполняется вся стопка
+    void renderStacked(const Simulation& sim, const uint8_t* previous, uint8_t* stack, int depth) const;
+
+    // Лучшее ядро, доступное на этом процессоре
+    static Kernel bestKernel();
+    static const char* kernelName(Kernel kernel);
+    // Ядро, недоступное на процессоре, заменяется лучшим доступным
+    void setKernel(Kernel kernel);
+    Kernel getKernel() const { return kernel; }
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    size_t frameBytes() const { return static_cast<size_t>(width) * height; }
+
+    // Заливка count байт и копирование строки в rows строк с шагом stride
+    using FillFunction = void (*)(uint8_t* dst, int count, uint8_t shade);
+    using ReplicateFunction = void (*)(const uint8_t* row, uint8_t* dst, int width, int rows, int stride);
+
+private:
+    int width;
+    int height;
+    int groundRow;          // Первая строка земли
+    Kernel kernel;
+    FillFunction fill;
+    ReplicateFunction replicate;
+
+    // Полуинтервал пикселей [first, last) кадра размером size, центры которых лежат
+    // в [from, to) на оси экрана длиной screen; считается в целых без ошибок округления
+    static void pixelRange(int from, int to, int screen, int size, int limit, int& first, int& last);
+};
+
+#endif // OBSERVATION_RASTERIZER_H
@@ -0,0 +1,86 @@
+#include "Panel.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+Panel::Panel() :
+    texture(nullptr),
+    radius(0)
+{
+}
+
+Panel::~Panel() {
+    destroy();
+}
+
+bool Panel::create(SDL_Renderer* renderer, int radius, SDL_Color color) {
+    destroy();
+    this->radius = std::max(radius, 0);
+
+    // Текстура (2r+1)x(2r+1): четыре угла и однопиксельные полосы между ними
+    const int size = 2 * this->radius + 1;
+    SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(0, size, size, 32, SDL_PIXELFORMAT_ARGB8888);
+    if (!surface) {
+        std::cout << "Failed to create panel surface: " << SDL_GetError() << std::endl;
+        return false;
+    }
+
+    const float r = static_cast<float>(this->radius);
+    for (int py = 0; py < size; py++) {
+        Uint32* row = reinterpret_cast<Uint32*>(static_cast<Uint8*>(surface->pixels) + py * surface->pitch);
+        for (int px = 0; px < size; px++) {
+            // Покрытие пикселя по расстоянию до ближайшего центра скругления
+            const float cx = px + 0.5f;
+            const float cy = py + 0.5f;
+            const float nx = std::clamp(cx, r, size - r);
+            const float ny = std::clamp(cy, r, size - r);
+            const float distance = std::sqrt((cx - nx) * (cx - nx) + (cy - ny) * (cy - ny));
+            const float coverage = std::clamp(r - distance + 0.5f, 0.0f, 1.0f);
+            const Uint8 alpha = static_cast<Uint8>(std::lround(color.a * coverage));
+            row[px] = SDL_MapRGBA(surface->format, color.r, color.g, color.b, alpha);
+        }
+    }
+
+    texture = SDL_CreateTextureFromSurface(renderer, surface);
+    SDL_FreeSurface(surface);
+    if (!texture) {
+        std::cout << "Failed to create panel texture: " << SDL_GetError() << std::endl;
+        return false;
+    }
+    SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+    return true;
+}
+
+void Panel::draw(SDL_Renderer* renderer, int x, int y, int w, int h) const {
+    if (!texture) {
+        return;
+    }
+
+    const int r = std::min(radius, std::min(w, h) / 2);
+    const int R = radius;
+    const int innerW = w - 2 * r;
+    const int innerH = h - 2 * r;
+
+    // Углы
+    const SDL_Rect srcCorners[4] = {{0, 0, R, R}, {R + 1, 0, R, R}, {0, R + 1, R, R}, {R + 1, R + 1, R, R}};
+    const SDL_Rect dstCorners[4] = {{x, y, r, r}, {x + w - r, y, r, r}, {x, y + h - r, r, r}, {x + w - r, y + h - r, r, r}};
+    // Стороны и центр растягиваются из однопиксельных полос
+    const SDL_Rect srcEdges[5] = {{R, 0, 1, R}, {R, R + 1, 1, R}, {0, R, R, 1}, {R + 1, R, R, 1}, {R, R, 1, 1}};
+    const SDL_Rect dstEdges[5] = {{x + r, y, innerW, r}, {x + r, y + h - r, innerW, r},
+                                  {x, y + r, r, innerH}, {x + w - r, y + r, r, innerH},
+                                  {x + r, y + r, innerW, innerH}};
+
+    for (int i = 0; i < 4; i++) {
+        SDL_RenderCopy(renderer, texture, &srcCorners[i], &dstCorners[i]);
+    }
+    for (int i = 0; i < 5; i++) {
+        SDL_RenderCopy(renderer, texture, &srcEdges[i], &dstEdges[i]);
+    }
+}
+
+void Panel::destroy() {
+    if (texture) {
+        SDL_DestroyTexture(texture);
+        texture = nullptr;
+    }
+}
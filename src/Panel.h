@@ -0,0 +1,25 @@
+#ifndef PANEL_H
+#define PANEL_H
+
+#include <SDL.h>
+
+// Полупрозрачная панель со скруглёнными углами (nine-slice).
+// Углы растеризуются с антиалиасингом в маленькую текстуру один раз,
+// панель любого размера рисуется за DRAW_CALLS вызовов SDL_RenderCopy.
+class Panel {
+public:
+    static const int DRAW_CALLS = 9;
+
+    Panel();
+    ~Panel();
+
+    bool create(SDL_Renderer* renderer, int radius, SDL_Color color);
+    void draw(SDL_Renderer* renderer, int x, int y, int w, int h) const;
+    void destroy();
+
+private:
+    SDL_Texture* texture;
+    int radius;
+};
+
+#endif // PANEL_H
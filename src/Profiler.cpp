@@ -0,0 +1,120 @@
+#include "Profiler.h"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+
+Profiler::Profiler() :
+    enabled(false),
+    frameStart(0),
+    frameOpen(false),
+    frameMs{},
+    frameCount(0),
+    dropped(0)
+{
+}
+
+Profiler& Profiler::instance() {
+    static Profiler profiler;
+    return profiler;
+}
+
+uint64_t Profiler::nowUs() {
+    static const auto origin = std::chrono::steady_clock::now();
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - origin).count());
+}
+
+uint32_t Profiler::threadIndex() {
+    static std::atomic<uint32_t> nextIndex{1};
+    thread_local uint32_t index = nextIndex.fetch_add(1);
+    return index;
+}
+
+void Profiler::setEnabled(bool value) {
+    if (value) {
+        std::lock_guard<std::mutex> lock(mutex);
+        // Память под все MAX_EVENTS событий (32 МБ) выделяется один раз при включении:
+        // иначе вектор перераспределялся бы под мьютексом посреди трассы и сам
+        // давал бы те рывки кадров, которые профилировщик должен находить
+        events.reserve(MAX_EVENTS);
+    }
+    enabled.store(value, std::memory_order_relaxed);
+}
+
+void Profiler::beginFrame() {
+    frameOpen = isEnabled();
+    if (frameOpen) {
+        frameStart = nowUs();
+    }
+}
+
+void Profiler::endFrame() {
+    if (!frameOpen) {
+        return;
+    }
+    frameOpen = false;
+    const uint64_t duration = nowUs() - frameStart;
+    frameMs[frameCount % FRAME_HISTORY] = duration / 1000.0f;
+    frameCount++;
+    record("frame", frameStart, duration);
+}
+
+void Profiler::record(const char* name, uint64_t startUs, uint64_t durationUs) {
+    const uint32_t thread = threadIndex();
+    std::lock_guard<std::mutex> lock(mutex);
+    if (events.size() >= MAX_EVENTS) {
+        dropped++;
+        return;
+    }
+    events.push_back(Event{name, startUs, durationUs, thread});
+}
+
+double Profiler::lastFrameMs() const {
+    if (frameCount == 0) {
+        return 0.0;
+    }
+    return frameMs[(frameCount - 1) % FRAME_HISTORY];
+}
+
+double Profiler::frameMsPercentile(double p) const {
+    const size_t count = std::min(frameCount, FRAME_HISTORY);
+    if (count == 0) {
+        return 0.0;
+    }
+    std::array<float, FRAME_HISTORY> sorted;
+    std::copy(frameMs.begin(), frameMs.begin() + count, sorted.begin());
+    const size_t index = std::min(count - 1, static_cast<size_t>(p / 100.0 * count));
+    std::nth_element(sorted.begin(), sorted.begin() + index, sorted.begin() + count);
+    return sorted[index];
+}
+
+size_t Profiler::eventCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return events.size();
+}
+
+bool Profiler::writeChromeTrace(const std::string& path) const {
+    std::ofstream out(path);
+    if (!out) {
+        std::cout << "Failed to open trace file " << path << std::endl;
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    out << "{\"traceEvents\":[\n";
+    for (size_t i = 0; i < events.size(); i++) {
+        const Event& e = events[i];
+        out << "{\"name\":\"" << e.name << "\",\"ph\":\"X\",\"ts\":" << e.start
+            << ",\"dur\":" << e.duration << ",\"pid\":1,\"tid\":" << e.thread << "}"
+            << (i + 1 < events.size() ? ",\n" : "\n");
+    }
+    out << "],\"displayTimeUnit\":\"ms\"}\n";
+
+    std::cout << "Trace written to " << path << " (" << events.size() << " events";
+    if (dropped) {
+        std::cout << ", " << dropped << " dropped";
+    }
+    std::cout << ")" << std::endl;
+    return true;
+}
@@ -0,0 +1,90 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Лёгкий профилировщик: замеры областей кода (PROFILE_SCOPE), история
+// времени кадров для перцентилей и выгрузка в формате Chrome trace_event.
+// В выключенном состоянии замер стоит одну проверку флага.
+class Profiler {
+public:
+    static constexpr size_t FRAME_HISTORY = 240;
+    static constexpr size_t MAX_EVENTS = 1 << 20;
+
+    class Scope {
+    public:
+        explicit Scope(const char* name) :
+            name(name),
+            active(Profiler::instance().isEnabled()),
+            start(active ? Profiler::nowUs() : 0)
+        {
+        }
+
+        ~Scope() {
+            if (active) {
+                Profiler::instance().record(name, start, Profiler::nowUs() - start);
+            }
+        }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        const char* name;
+        bool active;
+        uint64_t start;
+    };
+
+    static Profiler& instance();
+    static uint64_t nowUs();
+    // Небольшой номер текущего потока (1 — первый обратившийся)
+    static uint32_t threadIndex();
+
+    void setEnabled(bool value);
+    bool isEnabled() const { return enabled.load(std::memory_order_relaxed); }
+
+    // Границы кадра: длительность попадает в историю для перцентилей
+    void beginFrame();
+    void endFrame();
+
+    void record(const char* name, uint64_t startUs, uint64_t durationUs);
+
+    double lastFrameMs() const;
+    // p в диапазоне [0, 100] по последним FRAME_HISTORY кадрам
+    double frameMsPercentile(double p) const;
+    size_t eventCount() const;
+    uint64_t droppedEvents() const { return dropped; }
+
+    bool writeChromeTrace(const std::string& path) const;
+
+private:
+    struct Event {
+        const char* name;
+        uint64_t start;
+        uint64_t duration;
+        uint32_t thread;
+    };
+
+    Profiler();
+
+    std::atomic<bool> enabled;
+    uint64_t frameStart;
+    bool frameOpen;
+    std::array<float, FRAME_HISTORY> frameMs;
+    size_t frameCount;
+
+    mutable std::mutex mutex;
+    std::vector<Event> events;
+    uint64_t dropped;
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_SCOPE(name) Profiler::Scope PROFILE_CONCAT(profileScope, __LINE__)(name)
+
+#endif // PROFILER_H
@@ -0,0 +1,45 @@
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include <cstdint>
+
+// Генератор PCG32: одинаковая последовательность на любой платформе
+// и компиляторе при одинаковом seed, в отличие от rand()
+class Random {
+public:
+    explicit Random(uint64_t seed = 0) { reseed(seed); }
+
+    void reseed(uint64_t seed) {
+        state = 0;
+        next();
+        state += seed;
+        next();
+    }
+
+    uint32_t next() {
+        const uint64_t old = state;
+        state = old * 6364136223846793005ULL + INCREMENT;
+        const uint32_t xorshifted = static_cast<uint32_t>(((old >> 18u) ^ old) >> 27u);
+        const uint32_t rot = static_cast<uint32_t>(old >> 59u);
+        return (xorshifted >> rot) | (xorshifted << ((32 - rot) & 31));
+    }
+
+    // Равномерно в [0, bound) без смещения по модулю
+    uint32_t bounded(uint32_t bound) {
+        const uint32_t threshold = (0u - bound) % bound;
+        for (;;) {
+            const uint32_t value = next();
+            if (value >= threshold) {
+                return value % bound;
+            }
+        }
+    }
+
+    uint64_t getState() const { return state; }
+
+private:
+    static const uint64_t INCREMENT = 1442695040888963407ULL;
+    uint64_t state;
+};
+
+#endif // RANDOM_H
@@ -0,0 +1,191 @@
+#include "Replay.h"
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+namespace {
+
+void putBytes(std::vector<unsigned char>& out, uint64_t value, int count) {
+    for (int i = 0; i < count; i++) {
+        out.push_back(static_cast<unsigned char>(value >> (8 * i)));
+    }
+}
+
+void putVarint(std::vector<unsigned char>& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<unsigned char>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<unsigned char>(value));
+}
+
+class Reader {
+public:
+    Reader(const std::vector<unsigned char>& data) : data(data), pos(0), ok(true) {}
+
+    uint64_t bytes(int count) {
+        if (pos + count > data.size()) {
+            ok = false;
+            return 0;
+        }
+        uint64_t value = 0;
+        for (int i = 0; i < count; i++) {
+            value |= static_cast<uint64_t>(data[pos++]) << (8 * i);
+        }
+        return value;
+    }
+
+    uint64_t varint() {
+        uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (pos >= data.size()) {
+                break;
+            }
+            const unsigned char byte = data[pos++];
+            value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            if (!(byte & 0x80)) {
+                return value;
+            }
+        }
+        ok = false;
+        return 0;
+    }
+
+    bool good() const { return ok; }
+
+private:
+    const std::vector<unsigned char>& data;
+    size_t pos;
+    bool ok;
+};
+
+} // namespace
+
+bool Replay::save(const std::string& path) const {
+    std::vector<unsigned char> out;
+    out.insert(out.end(), {'F', 'B', 'R', 'P'});
+    putBytes(out, VERSION, 2);
+    putBytes(out, tickRate, 2);
+    putBytes(out, seed, 8);
+    putBytes(out, finalTick, 8);
+    putBytes(out, static_cast<uint32_t>(finalScore), 4);
+    putBytes(out, finalHash, 8);
+    putBytes(out, flapTicks.size(), 4);
+
+    uint64_t previous = 0;
+    for (uint64_t tick : flapTicks) {
+        putVarint(out, tick - previous);
+        previous = tick;
+    }
+
+    std::ofstream file(path, std::ios::binary);
+    if (!file.write(reinterpret_cast<const char*>(out.data()), out.size())) {
+        std::cout << "Failed to write replay " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool Replay::load(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        std::cout << "Failed to open replay " << path << std::endl;
+        return false;
+    }
+    std::vector<unsigned char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    if (data.size() < 4 || memcmp(data.data(), "FBRP", 4) != 0) {
+        std::cout << "Not a replay file: " << path << std::endl;
+        return false;
+    }
+    Reader reader(data);
+    reader.bytes(4);
+    if (reader.bytes(2) != VERSION) {
+        std::cout << "Unsupported replay version: " << path << std::endl;
+        return false;
+    }
+    tickRate = static_cast<uint16_t>(reader.bytes(2));
+    seed = reader.bytes(8);
+    finalTick = reader.bytes(8);
+    finalScore = static_cast<int32_t>(reader.bytes(4));
+    finalHash = reader.bytes(8);
+    const uint64_t count = reader.bytes(4);
+
+    flapTicks.clear();
+    uint64_t tick = 0;
+    for (uint64_t i = 0; i < count && reader.good(); i++) {
+        tick += reader.varint();
+        flapTicks.push_back(tick);
+    }
+    if (!reader.good()) {
+        std::cout << "Truncated replay: " << path << std::endl;
+        return false;
+    }
+    if (!isValid()) {
+        std::cout << "Invalid replay: " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool Replay::isValid() const {
+    if (finalTick > MAX_TICKS) {
+        return false;
+    }
+    // Взмах на тике t подаётся в шаг, который делает тик t, поэтому тик 0 невозможен
+    uint64_t previous = 0;
+    for (uint64_t tick : flapTicks) {
+        if (tick <= previous || tick > finalTick) {
+            return false;
+        }
+        previous = tick;
+    }
+    return true;
+}
+
+void ReplayRecorder::begin(uint64_t seed, uint16_t tickRate) {
+    replay = Replay();
+    replay.seed = seed;
+    replay.tickRate = tickRate;
+    active = true;
+}
+
+void ReplayRecorder::recordStep(const Simulation& sim, const Simulation::Input& input) {
+    if (active && input.flap) {
+        replay.flapTicks.push_back(sim.getTick());
+    }
+}
+
+void ReplayRecorder::finish(const Simulation& sim) {
+    if (!active) {
+        return;
+    }
+    replay.finalTick = sim.getTick();
+    replay.finalScore = sim.getScore();
+    replay.finalHash = sim.stateHash();
+    active = false;
+}
+
+ReplayCheck verifyReplay(const Replay& replay) {
+    if (!replay.isValid()) {
+        return ReplayCheck{false, 0, 0, 0};
+    }
+    Simulation sim(replay.seed);
+    size_t next = 0;
+    Simulation::Input input;
+    while (sim.getTick() < replay.finalTick) {
+        input.flap = next < replay.flapTicks.size() && replay.flapTicks[next] == sim.getTick() + 1;
+        if (input.flap) {
+            next++;
+        }
+        sim.step(input);
+    }
+
+    ReplayCheck check;
+    check.score = sim.getScore();
+    check.hash = sim.stateHash();
+    check.ticks = sim.getTick();
+    check.matches = next == replay.flapTicks.size() &&
+                    check.score == replay.finalScore && check.hash == replay.finalHash;
+    return check;
+}
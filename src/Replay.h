@@ -0,0 +1,59 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include "Simulation.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Запись сессии: seed и номера тиков, на которых был взмах.
+// Формат файла (little-endian):
+//   "FBRP", u16 версия, u16 тиков в секунду, u64 seed,
+//   u64 последний тик, i32 итоговый счёт, u64 хэш состояния,
+//   u32 число взмахов, далее разности номеров тиков в varint
+struct Replay {
+    static const uint16_t VERSION = 1;
+    // Предел длины записи: четыре часа игры. Файлы приходят извне, и без предела
+    // проверка записи с огромным последним тиком не закончилась бы
+    static const uint64_t MAX_TICKS = 4ull * 60 * 60 * Simulation::TICKS_PER_SECOND;
+
+    uint64_t seed = 0;
+    uint16_t tickRate = Simulation::TICKS_PER_SECOND;
+    std::vector<uint64_t> flapTicks;
+    uint64_t finalTick = 0;
+    int32_t finalScore = 0;
+    uint64_t finalHash = 0;
+
+    bool save(const std::string& path) const;
+    // Отвергает и повреждённые, и неправдоподобные записи (см. isValid)
+    bool load(const std::string& path);
+    // Последний тик не больше MAX_TICKS, взмахи строго возрастают и не позже последнего тика
+    bool isValid() const;
+};
+
+// Запись входов во время игры
+class ReplayRecorder {
+public:
+    void begin(uint64_t seed, uint16_t tickRate);
+    // Вызывается после каждого Simulation::step
+    void recordStep(const Simulation& sim, const Simulation::Input& input);
+    void finish(const Simulation& sim);
+    bool isActive() const { return active; }
+    const Replay& getReplay() const { return replay; }
+
+private:
+    Replay replay;
+    bool active = false;
+};
+
+struct ReplayCheck {
+    bool matches;
+    int score;
+    uint64_t hash;
+    uint64_t ticks;
+};
+
+// Пересимуляция без SDL и сверка счёта и хэша с записанными
+ReplayCheck verifyReplay(const Replay& replay);
+
+#endif // REPLAY_H
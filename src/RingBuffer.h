@@ -0,0 +1,70 @@
+#ifndef RING_BUFFER_H
+#define RING_BUFFER_H
+
+#include <array>
+#include <cstddef>
+
+// Кольцевой буфер фиксированной ёмкости без выделений памяти.
+// Capacity должна быть степенью двойки.
+template <typename T, size_t Capacity>
+class RingBuffer {
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    class const_iterator {
+    public:
+        const_iterator(const RingBuffer* buffer, size_t index) : buffer(buffer), index(index) {}
+        const T& operator*() const { return (*buffer)[index]; }
+        const T* operator->() const { return &(*buffer)[index]; }
+        const_iterator& operator++() { ++index; return *this; }
+        bool operator!=(const const_iterator& other) const { return index != other.index; }
+        bool operator==(const const_iterator& other) const { return index == other.index; }
+
+    private:
+        const RingBuffer* buffer;
+        size_t index;
+    };
+
+    // При переполнении вытесняется самый старый элемент
+    void push_back(const T& value) {
+        if (count == Capacity) {
+            pop_front();
+        }
+        items[(head + count) & (Capacity - 1)] = value;
+        count++;
+    }
+
+    void pop_front() {
+        if (count > 0) {
+            head = (head + 1) & (Capacity - 1);
+            count--;
+        }
+    }
+
+    void clear() {
+        head = 0;
+        count = 0;
+    }
+
+    T& operator[](size_t i) { return items[(head + i) & (Capacity - 1)]; }
+    const T& operator[](size_t i) const { return items[(head + i) & (Capacity - 1)]; }
+    T& front() { return items[head]; }
+    const T& front() const { return items[head]; }
+    T& back() { return (*this)[count - 1]; }
+    const T& back() const { return (*this)[count - 1]; }
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    bool full() const { return count == Capacity; }
+    static constexpr size_t capacity() { return Capacity; }
+
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, count); }
+
+private:
+    std::array<T, Capacity> items{};
+    size_t head = 0;
+    size_t count = 0;
+};
+
+#endif // RING_BUFFER_H
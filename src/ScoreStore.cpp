@@ -0,0 +1,528 @@
+#include "ScoreStore.h"
+#include <algorithm>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <unordered_set>
+#include <vector>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+const size_t HEADER_SIZE = 16;
+const int BLOCK_SIZE = 256;
+const size_t BLOCK_COUNT = (ScoreStore::MAX_SCORE + 1) / BLOCK_SIZE;
+const size_t READ_CHUNK = 4096;     // Записей за одно чтение журнала
+const size_t WRITE_CHUNK = 64;      // Записей за одну запись в журнал, буфер на стеке
+
+void putBytes(unsigned char* out, uint64_t value, int count) {
+    for (int i = 0; i < count; i++) {
+        out[i] = static_cast<unsigned char>(value >> (8 * i));
+    }
+}
+
+uint64_t getBytes(const unsigned char* data, int count) {
+    uint64_t value = 0;
+    for (int i = 0; i < count; i++) {
+        value |= static_cast<uint64_t>(data[i]) << (8 * i);
+    }
+    return value;
+}
+
+// FNV-1a по первым 28 байтам записи
+uint32_t recordChecksum(const unsigned char* data) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < ScoreStore::RECORD_SIZE - 4; i++) {
+        hash = (hash ^ data[i]) * 16777619u;
+    }
+    return hash;
+}
+
+void encodeRecord(const ScoreStore::Record& record, unsigned char* out) {
+    putBytes(out, static_cast<uint32_t>(record.score), 4);
+    putBytes(out + 4, record.durationMs, 4);
+    putBytes(out + 8, record.seed, 8);
+    putBytes(out + 16, static_cast<uint64_t>(record.timestamp), 8);
+    putBytes(out + 24, record.cabinet, 4);
+    putBytes(out + 28, recordChecksum(out), 4);
+}
+
+bool checksumMatches(const unsigned char* data) {
+    return getBytes(data + 28, 4) == recordChecksum(data);
+}
+
+bool decodeRecord(const unsigned char* data, ScoreStore::Record& record) {
+    if (!checksumMatches(data)) {
+        return false;
+    }
+    record.score = static_cast<int32_t>(getBytes(data, 4));
+    record.durationMs = static_cast<uint32_t>(getBytes(data + 4, 4));
+    record.seed = getBytes(data + 8, 8);
+    record.timestamp = static_cast<int64_t>(getBytes(data + 16, 8));
+    record.cabinet = static_cast<uint32_t>(getBytes(data + 24, 4));
+    return record.score >= 0;
+}
+
+bool readHeader(std::ifstream& file, uint32_t& cabinet) {
+    unsigned char header[HEADER_SIZE];
+    if (!file.read(reinterpret_cast<char*>(header), HEADER_SIZE) || memcmp(header, "FBSL", 4) != 0 ||
+        getBytes(header + 4, 2) != ScoreStore::VERSION) {
+        return false;
+    }
+    cabinet = static_cast<uint32_t>(getBytes(header + 8, 4));
+    return true;
+}
+
+// Итог чтения журнала
+struct ReadResult {
+    uint64_t bytes = 0;         // Все целые записи, включая испорченные
+    uint64_t skipped = 0;       // Испорченные записи, не переданные дальше
+    bool lastTorn = false;      // Последняя целая запись не сходится с суммой
+};
+
+// Читает целые записи с проверкой суммы, начиная с текущей позиции, до конца файла.
+// Испорченные записи пропускаются: одна плохая запись не должна прятать все следующие
+template <typename Callback>
+ReadResult readRecords(std::ifstream& file, Callback callback) {
+    std::vector<unsigned char> chunk(READ_CHUNK * ScoreStore::RECORD_SIZE);
+    std::vector<ScoreStore::Record> records;
+    records.reserve(READ_CHUNK);
+    ReadResult result;
+    for (;;) {
+        file.read(reinterpret_cast<char*>(chunk.data()), static_cast<std::streamsize>(chunk.size()));
+        const size_t count = static_cast<size_t>(file.gcount()) / ScoreStore::RECORD_SIZE;
+        records.clear();
+        for (size_t i = 0; i < count; i++) {
+            const unsigned char* data = chunk.data() + i * ScoreStore::RECORD_SIZE;
+            ScoreStore::Record record;
+            if (decodeRecord(data, record)) {
+                records.push_back(record);
+                result.lastTorn = false;
+            }
+            else {
+                result.skipped++;
+                result.lastTorn = !checksumMatches(data);
+            }
+        }
+        if (!records.empty()) {
+            callback(records.data(), records.size());
+        }
+        result.bytes += count * ScoreStore::RECORD_SIZE;
+        if (count < READ_CHUNK) {
+            return result;
+        }
+    }
+}
+
+} // namespace
+
+// Индекс хранится в порядке байт этой машины: он локальный и всегда может быть перестроен
+struct ScoreStore::Index {
+    char magic[4];
+    uint16_t version;
+    uint16_t updating;          // Ненулевой — обновление прервано, индекс недостоверен
+    uint32_t cabinet;
+    uint32_t topCount;
+    uint64_t logBytes;          // Проиндексированная часть журнала вместе с заголовком
+    uint64_t records;
+    uint32_t hasPersonalBest;
+    uint32_t reserved;
+    Record personalBest;
+    Record top[TOP_CAPACITY];
+    uint64_t blocks[BLOCK_COUNT];
+    uint64_t counts[MAX_SCORE + 1];
+};
+
+ScoreStore::ScoreStore() :
+    log(nullptr),
+    logBytes(0),
+    cabinet(0),
+    index(nullptr),
+    indexFileHandle(nullptr),
+    indexMappingHandle(nullptr),
+    runKeysBytes(0)
+{
+}
+
+ScoreStore::~ScoreStore() {
+    close();
+}
+
+bool ScoreStore::open(const std::string& path) {
+    close();
+    logPath = path;
+
+    std::error_code error;
+    if (!std::filesystem::exists(logPath, error) || std::filesystem::file_size(logPath, error) == 0) {
+        // Новый журнал получает случайный номер автомата для личных рекордов
+        std::random_device device;
+        const uint32_t id = device() ^ static_cast<uint32_t>(time(nullptr));
+        unsigned char header[HEADER_SIZE] = {'F', 'B', 'S', 'L'};
+        putBytes(header + 4, VERSION, 2);
+        putBytes(header + 8, id, 4);
+        std::ofstream file(logPath, std::ios::binary);
+        if (!file.write(reinterpret_cast<const char*>(header), HEADER_SIZE)) {
+            std::cout << "Failed to create score log " << logPath << std::endl;
+            return false;
+        }
+    }
+
+    std::ifstream file(logPath, std::ios::binary);
+    if (!file || !readHeader(file, cabinet)) {
+        std::cout << "Score log " << logPath << " has an unsupported format" << std::endl;
+        return false;
+    }
+    file.close();
+
+    if (!mapIndex(std::filesystem::path(logPath).replace_extension(".idx").string())) {
+        return false;
+    }
+    if (!catchUp()) {
+        unmapIndex();
+        return false;
+    }
+
+    log = fopen(logPath.c_str(), "ab");
+    if (!log) {
+        std::cout << "Failed to open score log " << logPath << " for writing" << std::endl;
+        unmapIndex();
+        return false;
+    }
+    // Без буфера stdio: он выделялся бы при первой дозаписи, в кадре конца забега,
+    // а записи и так уходят целыми порциями
+    setvbuf(log, nullptr, _IONBF, 0);
+    return true;
+}
+
+void ScoreStore::close() {
+    if (log) {
+        fclose(log);
+        log = nullptr;
+    }
+    unmapIndex();
+    logBytes = 0;
+    std::vector<RunKey>().swap(runKeys);
+    runKeysBytes = 0;
+}
+
+bool ScoreStore::catchUp() {
+    std::error_code error;
+    const uint64_t fileSize = std::filesystem::file_size(logPath, error);
+    if (error) {
+        return false;
+    }
+
+    const bool indexValid = memcmp(index->magic, "FBSI", 4) == 0 && index->version == VERSION &&
+                            index->updating == 0 && index->cabinet == cabinet &&
+                            index->logBytes >= HEADER_SIZE && index->logBytes <= fileSize &&
+                            (index->logBytes - HEADER_SIZE) % RECORD_SIZE == 0;
+    if (!indexValid) {
+        resetIndex();
+    }
+
+    // Дочитываем записи, которых ещё нет в индексе
+    std::ifstream file(logPath, std::ios::binary);
+    file.seekg(static_cast<std::streamoff>(index->logBytes));
+    index->updating = 1;
+    ReadResult result = readRecords(file, [this](const Record* records, size_t count) {
+        for (size_t i = 0; i < count; i++) {
+            addToIndex(records[i]);
+        }
+    });
+    file.close();
+
+    // Прерванная дозапись оставляет только хвост: неполную запись или последнюю
+    // запись с неверной суммой. Их можно отрезать; испорченные записи в середине
+    // журнала остаются на месте и пропускаются, целые записи после них сохраняются
+    uint64_t keep = index->logBytes + result.bytes;
+    if (result.lastTorn) {
+        keep -= RECORD_SIZE;
+        result.skipped--;
+    }
+    if (result.skipped > 0) {
+        std::cout << "Score log " << logPath << ": skipped " << result.skipped
+                  << " damaged records" << std::endl;
+    }
+    index->logBytes = keep;
+    index->updating = 0;
+    logBytes = keep;
+
+    if (logBytes < fileSize) {
+        std::cout << "Score log " << logPath << ": dropping " << fileSize - logBytes
+                  << " bytes of a torn record" << std::endl;
+        std::filesystem::resize_file(logPath, logBytes, error);
+        if (error) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ScoreStore::append(const Record& record) {
+    return append(&record, 1);
+}
+
+bool ScoreStore::append(const Record* records, size_t count) {
+    if (!log) {
+        return false;
+    }
+
+    // Сначала журнал: запись, не попавшая в индекс, будет дочитана при следующем открытии.
+    // Запись порциями через буфер на стеке: дозапись из кадра игры не выделяет память
+    unsigned char data[WRITE_CHUNK * RECORD_SIZE];
+    for (size_t first = 0; first < count; first += WRITE_CHUNK) {
+        const size_t chunk = std::min(count - first, WRITE_CHUNK);
+        for (size_t i = 0; i < chunk; i++) {
+            encodeRecord(records[first + i], data + i * RECORD_SIZE);
+        }
+        if (fwrite(data, RECORD_SIZE, chunk, log) != chunk) {
+            // Часть записей могла попасть в журнал мимо индекса: он перестроится при открытии
+            std::cout << "Failed to append to the score log" << std::endl;
+            index->updating = 1;
+            fclose(log);
+            log = nullptr;
+            return false;
+        }
+    }
+
+    index->updating = 1;
+    for (size_t i = 0; i < count; i++) {
+        addToIndex(records[i]);
+    }
+    logBytes += count * RECORD_SIZE;
+    index->logBytes = logBytes;
+    index->updating = 0;
+    return true;
+}
+
+bool ScoreStore::merge(const std::string& otherLogPath, uint64_t* added) {
+    std::error_code error;
+    if (!log || std::filesystem::equivalent(logPath, otherLogPath, error)) {
+        return false;
+    }
+    std::ifstream file(otherLogPath, std::ios::binary);
+    uint32_t otherCabinet = 0;
+    if (!file || !readHeader(file, otherCabinet)) {
+        std::cout << "Score log " << otherLogPath << " has an unsupported format" << std::endl;
+        return false;
+    }
+
+    if (!syncRunKeys()) {
+        return false;
+    }
+
+    // Новые забеги проверяются и по журналу, и по уже добавленным из этого файла
+    bool ok = true;
+    uint64_t merged = 0;
+    std::unordered_set<RunKey, RunKeyHash> fresh;
+    std::vector<Record> batch;
+    batch.reserve(READ_CHUNK);
+    readRecords(file, [this, &ok, &merged, &fresh, &batch](const Record* records, size_t count) {
+        batch.clear();
+        for (size_t i = 0; i < count; i++) {
+            const RunKey key = {records[i].cabinet, records[i].timestamp, records[i].seed};
+            if (!std::binary_search(runKeys.begin(), runKeys.end(), key) && fresh.insert(key).second) {
+                batch.push_back(records[i]);
+            }
+        }
+        if (!ok || batch.empty()) {
+            return;
+        }
+        if (append(batch.data(), batch.size())) {
+            merged += batch.size();
+        }
+        else {
+            ok = false;
+        }
+    });
+    if (added) {
+        *added = merged;
+    }
+
+    const size_t known = runKeys.size();
+    runKeys.insert(runKeys.end(), fresh.begin(), fresh.end());
+    std::sort(runKeys.begin() + known, runKeys.end());
+    std::inplace_merge(runKeys.begin(), runKeys.begin() + known, runKeys.end());
+    runKeysBytes = logBytes;
+    return ok;
+}
+
+bool ScoreStore::syncRunKeys() {
+    // Дочитываются ключи записей, появившихся с прошлого слияния
+    std::ifstream file(logPath, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+    const size_t known = runKeys.size();
+    file.seekg(static_cast<std::streamoff>(std::max<uint64_t>(runKeysBytes, HEADER_SIZE)));
+    readRecords(file, [this](const Record* records, size_t count) {
+        for (size_t i = 0; i < count; i++) {
+            runKeys.push_back(RunKey{records[i].cabinet, records[i].timestamp, records[i].seed});
+        }
+    });
+    std::sort(runKeys.begin() + known, runKeys.end());
+    std::inplace_merge(runKeys.begin(), runKeys.begin() + known, runKeys.end());
+    runKeysBytes = logBytes;
+    return true;
+}
+
+bool ScoreStore::RunKey::operator<(const RunKey& other) const {
+    if (cabinet != other.cabinet) {
+        return cabinet < other.cabinet;
+    }
+    if (timestamp != other.timestamp) {
+        return timestamp < other.timestamp;
+    }
+    return seed < other.seed;
+}
+
+bool ScoreStore::RunKey::operator==(const RunKey& other) const {
+    return cabinet == other.cabinet && timestamp == other.timestamp && seed == other.seed;
+}
+
+size_t ScoreStore::RunKeyHash::operator()(const RunKey& key) const {
+    uint64_t hash = key.seed * 0x9E3779B97F4A7C15ull;
+    hash ^= (static_cast<uint64_t>(key.timestamp) + (hash << 6) + (hash >> 2)) * 0xBF58476D1CE4E5B9ull;
+    hash ^= key.cabinet + (hash << 6) + (hash >> 2);
+    return static_cast<size_t>(hash ^ (hash >> 31));
+}
+
+uint64_t ScoreStore::size() const {
+    return index ? index->records : 0;
+}
+
+size_t ScoreStore::top(Record* out, size_t count) const {
+    if (!index) {
+        return 0;
+    }
+    count = std::min<size_t>(count, index->topCount);
+    std::copy(index->top, index->top + count, out);
+    return count;
+}
+
+bool ScoreStore::personalBest(Record& out) const {
+    if (!index || !index->hasPersonalBest) {
+        return false;
+    }
+    out = index->personalBest;
+    return true;
+}
+
+double ScoreStore::fractionBelow(int score) const {
+    if (!index || index->records == 0 || score <= 0) {
+        return 0.0;
+    }
+    // Целые блоки по суммам, остаток — по гистограмме: не больше 2 * BLOCK_SIZE сложений
+    const int bucket = std::min(score, MAX_SCORE);
+    const int block = bucket / BLOCK_SIZE;
+    uint64_t below = 0;
+    for (int i = 0; i < block; i++) {
+        below += index->blocks[i];
+    }
+    for (int i = block * BLOCK_SIZE; i < bucket; i++) {
+        below += index->counts[i];
+    }
+    return static_cast<double>(below) / static_cast<double>(index->records);
+}
+
+void ScoreStore::resetIndex() {
+    memset(index, 0, sizeof(Index));
+    memcpy(index->magic, "FBSI", 4);
+    index->version = VERSION;
+    index->cabinet = cabinet;
+    index->logBytes = HEADER_SIZE;
+}
+
+void ScoreStore::addToIndex(const Record& record) {
+    const int bucket = std::min<int32_t>(record.score, MAX_SCORE);
+    index->counts[bucket]++;
+    index->blocks[bucket / BLOCK_SIZE]++;
+    index->records++;
+
+    if (record.cabinet == cabinet && (!index->hasPersonalBest || record.score > index->personalBest.score)) {
+        index->personalBest = record;
+        index->hasPersonalBest = 1;
+    }
+
+    // Вставка в отсортированный список лучших; при равном счёте новая запись идёт после старых
+    if (index->topCount == TOP_CAPACITY && record.score <= index->top[TOP_CAPACITY - 1].score) {
+        return;
+    }
+    size_t i = index->topCount < TOP_CAPACITY ? index->topCount++ : TOP_CAPACITY - 1;
+    for (; i > 0 && index->top[i - 1].score < record.score; i--) {
+        index->top[i] = index->top[i - 1];
+    }
+    index->top[i] = record;
+}
+
+bool ScoreStore::mapIndex(const std::string& path) {
+    const size_t size = sizeof(Index);
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr, OPEN_ALWAYS,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        std::cout << "Failed to open score index " << path << std::endl;
+        return false;
+    }
+    // Отображение нужного размера само дополняет файл
+    HANDLE view = CreateFileMappingA(file, nullptr, PAGE_READWRITE, 0, static_cast<DWORD>(size), nullptr);
+    void* mapping = view ? MapViewOfFile(view, FILE_MAP_WRITE, 0, 0, size) : nullptr;
+    if (!mapping) {
+        std::cout << "Failed to map score index " << path << std::endl;
+        if (view) {
+            CloseHandle(view);
+        }
+        CloseHandle(file);
+        return false;
+    }
+    indexFileHandle = file;
+    indexMappingHandle = view;
+#else
+    const int fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    struct stat info;
+    if (fd < 0 || fstat(fd, &info) != 0 ||
+        (static_cast<size_t>(info.st_size) != size && ftruncate(fd, static_cast<off_t>(size)) != 0)) {
+        std::cout << "Failed to open score index " << path << std::endl;
+        if (fd >= 0) {
+            ::close(fd);
+        }
+        return false;
+    }
+    void* mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        std::cout << "Failed to map score index " << path << std::endl;
+        return false;
+    }
+#endif
+    index = static_cast<Index*>(mapping);
+    return true;
+}
+
+void ScoreStore::unmapIndex() {
+    if (!index) {
+        return;
+    }
+#ifdef _WIN32
+    UnmapViewOfFile(index);
+    CloseHandle(static_cast<HANDLE>(indexMappingHandle));
+    CloseHandle(static_cast<HANDLE>(indexFileHandle));
+    indexMappingHandle = nullptr;
+    indexFileHandle = nullptr;
+#else
+    munmap(index, sizeof(Index));
+#endif
+    index = nullptr;
+}
@@ -0,0 +1,96 @@
+#ifndef SCORE_STORE_H
+#define SCORE_STORE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// Таблица результатов забегов.
+// Журнал (формат FBSL v1) только дописывается: 16-байтный заголовок с номером
+// автомата и записи по 32 байта с контрольной суммой. Запись, оборванная сбоем,
+// отбрасывается при следующем открытии; испорченные записи внутри журнала
+// пропускаются, но не удаляются.
+// Индекс (файл .idx рядом с журналом) отображается в память. В нём гистограмма
+// счётов с суммами по блокам, лучшие забеги и личный рекорд, поэтому запросы
+// не читают журнал. Индекс производный: если он не сходится с журналом или его
+// обновление прервалось, индекс перестраивается по журналу.
+class ScoreStore {
+public:
+    static const uint16_t VERSION = 1;
+    static const int MAX_SCORE = 65535;         // Больший счёт попадает в гистограмму как MAX_SCORE
+    static const size_t TOP_CAPACITY = 64;
+    static const size_t RECORD_SIZE = 32;
+
+    struct Record {
+        int32_t score;
+        uint32_t durationMs;
+        uint64_t seed;
+        int64_t timestamp;      // Unix-время, секунды
+        uint32_t cabinet;       // Автомат, на котором сыгран забег
+    };
+
+    ScoreStore();
+    ~ScoreStore();
+
+    ScoreStore(const ScoreStore&) = delete;
+    ScoreStore& operator=(const ScoreStore&) = delete;
+
+    // Создаёт журнал, если его нет; индекс — тот же путь с расширением .idx
+    bool open(const std::string& logPath);
+    void close();
+    bool isOpen() const { return log != nullptr; }
+
+    bool append(const Record& record);
+    bool append(const Record* records, size_t count);
+    // Дописывает целые записи другого журнала (например, с других автоматов).
+    // Забеги, которые уже есть в журнале (тот же автомат, время и seed), пропускаются,
+    // поэтому повторное слияние того же журнала ничего не добавляет
+    bool merge(const std::string& otherLogPath, uint64_t* added = nullptr);
+
+    uint64_t size() const;
+    uint32_t getCabinet() const { return cabinet; }
+    // Лучшие забеги по убыванию счёта (при равенстве — более ранние), не больше TOP_CAPACITY
+    size_t top(Record* out, size_t count) const;
+    // Лучший забег этого автомата; false, если их ещё не было
+    bool personalBest(Record& out) const;
+    // Доля забегов со счётом строго меньше score, от 0 до 1
+    double fractionBelow(int score) const;
+
+private:
+    struct Index;
+
+    // Забег однозначно определяется автоматом, временем и seed
+    struct RunKey {
+        uint32_t cabinet;
+        int64_t timestamp;
+        uint64_t seed;
+
+        bool operator<(const RunKey& other) const;
+        bool operator==(const RunKey& other) const;
+    };
+    struct RunKeyHash {
+        size_t operator()(const RunKey& key) const;
+    };
+
+    FILE* log;
+    std::string logPath;
+    uint64_t logBytes;
+    uint32_t cabinet;
+    Index* index;
+    void* indexFileHandle;
+    void* indexMappingHandle;
+    // Ключи записей журнала по возрастанию для слияния; собираются при первом слиянии
+    std::vector<RunKey> runKeys;
+    uint64_t runKeysBytes;      // Часть журнала, чьи ключи уже в runKeys
+
+    bool mapIndex(const std::string& path);
+    void unmapIndex();
+    bool catchUp();
+    bool syncRunKeys();
+    void resetIndex();
+    void addToIndex(const Record& record);
+};
+
+#endif // SCORE_STORE_H
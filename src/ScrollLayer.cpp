@@ -0,0 +1,84 @@
+#include "ScrollLayer.h"
+#include <cmath>
+#include <iostream>
+
+ScrollLayer::ScrollLayer() :
+    texture(nullptr),
+    area{0, 0, 0, 0},
+    rate(1.0f),
+    opaque(false),
+    valid(false)
+{
+}
+
+ScrollLayer::~ScrollLayer() {
+    destroy();
+}
+
+bool ScrollLayer::create(SDL_Renderer* renderer, const SDL_Rect& layerArea, float layerRate, bool isOpaque) {
+    destroy();
+    area = layerArea;
+    rate = layerRate;
+    opaque = isOpaque;
+    if (!SDL_RenderTargetSupported(renderer)) {
+        return false;
+    }
+    texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET, area.w, area.h);
+    if (!texture) {
+        std::cout << "Failed to create scroll layer texture: " << SDL_GetError() << std::endl;
+        return false;
+    }
+    // Непрозрачная плитка копируется в кадр как есть, в программном рендерере это memcpy строк
+    SDL_SetTextureBlendMode(texture, opaque ? SDL_BLENDMODE_NONE : SDL_BLENDMODE_BLEND);
+    return true;
+}
+
+void ScrollLayer::destroy() {
+    if (texture) {
+        SDL_DestroyTexture(texture);
+        texture = nullptr;
+    }
+    valid = false;
+}
+
+bool ScrollLayer::compose(SDL_Renderer* renderer, SDL_Texture* atlas, const SDL_Rect& src) {
+    if (!texture || SDL_SetRenderTarget(renderer, texture) < 0) {
+        return false;
+    }
+
+    Uint8 r, g, b, a;
+    SDL_GetRenderDrawColor(renderer, &r, &g, &b, &a);
+    SDL_BlendMode atlasBlend;
+    SDL_GetTextureBlendMode(atlas, &atlasBlend);
+
+    // Непрозрачный слой смешивается с чёрным, как при рисовании на очищенный кадр.
+    // Прозрачный копируется без смешивания, чтобы альфа в плитке осталась исходной
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, opaque ? 255 : 0);
+    SDL_RenderClear(renderer);
+    SDL_SetTextureBlendMode(atlas, opaque ? atlasBlend : SDL_BLENDMODE_NONE);
+    const SDL_Rect tile = {0, 0, area.w, area.h};
+    SDL_RenderCopy(renderer, atlas, &src, &tile);
+
+    SDL_SetTextureBlendMode(atlas, atlasBlend);
+    SDL_SetRenderDrawColor(renderer, r, g, b, a);
+    SDL_SetRenderTarget(renderer, nullptr);
+    valid = true;
+    return true;
+}
+
+int ScrollLayer::offsetFor(double distance) const {
+    // Целые пиксели: плитка копируется без фильтрации, а неподвижный слой не меняет кадр
+    const double offset = std::fmod(distance * rate, static_cast<double>(area.w));
+    const int pixels = static_cast<int>(std::floor(offset));
+    return pixels > 0 ? pixels - area.w : pixels;
+}
+
+void ScrollLayer::draw(SDL_Renderer* renderer, int offset, RenderStats& stats) const {
+    const SDL_Rect src = {0, 0, area.w, area.h};
+    const SDL_Rect first = {area.x + offset, area.y, area.w, area.h};
+    const SDL_Rect second = {area.x + offset + area.w, area.y, area.w, area.h};
+    SDL_RenderCopy(renderer, texture, &src, &first);
+    SDL_RenderCopy(renderer, texture, &src, &second);
+    stats.drawCalls += 2;
+    stats.textureSwitches++;
+}
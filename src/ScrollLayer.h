@@ -0,0 +1,43 @@
+#ifndef SCROLL_LAYER_H
+#define SCROLL_LAYER_H
+
+#include <SDL.h>
+#include "SpriteBatch.h"
+
+// Бесконечно прокручиваемый по горизонтали слой (фон, земля).
+// Спрайт один раз масштабируется в плитку-текстуру размером со слой,
+// а в кадре плитка копируется дважды без масштабирования со сдвигом.
+// rate — скорость слоя относительно пройденного пути scrollOffset (параллакс).
+class ScrollLayer {
+public:
+    ScrollLayer();
+    ~ScrollLayer();
+
+    ScrollLayer(const ScrollLayer&) = delete;
+    ScrollLayer& operator=(const ScrollLayer&) = delete;
+
+    // opaque — слой рисуется поверх пустого кадра первым и копируется без смешивания.
+    // false, если рендерер не поддерживает текстуры-цели: тогда слой рисуется спрайтами
+    bool create(SDL_Renderer* renderer, const SDL_Rect& area, float rate, bool opaque);
+    void destroy();
+    bool isAvailable() const { return texture != nullptr; }
+
+    // Собирает плитку из области атласа; повторяется после потери текстур-целей
+    bool compose(SDL_Renderer* renderer, SDL_Texture* atlas, const SDL_Rect& src);
+    void invalidate() { valid = false; }
+    bool isValid() const { return valid; }
+
+    // Экранный сдвиг плитки в (-ширина, 0] для пройденного миром пути distance
+    int offsetFor(double distance) const;
+    void draw(SDL_Renderer* renderer, int offset, RenderStats& stats) const;
+    const SDL_Rect& getArea() const { return area; }
+
+private:
+    SDL_Texture* texture;
+    SDL_Rect area;
+    float rate;
+    bool opaque;
+    bool valid;
+};
+
+#endif // SCROLL_LAYER_H
@@ -0,0 +1,230 @@
+#include "Simulation.h"
+#include "Collision.h"
+#include <cmath>
+#include <algorithm>
+#include <cstring>
+
+Simulation::Simulation(uint64_t seed) :
+    course(seed),
+    state(WAITING),
+    birdVelocity(0),
+    birdAngle(0),
+    score(0),
+    scrollOffset(0),
+    gameTime(0),
+    tick(0),
+    playTicks(0),
+    gameSpeed(0.2f),
+    gravity(INITIAL_GRAVITY),
+    jumpForce(INITIAL_JUMP_FORCE)
+{
+    bird.x = SCREEN_WIDTH / 4;
+    bird.y = SCREEN_HEIGHT / 2;
+    bird.w = BIRD_WIDTH;
+    bird.h = BIRD_HEIGHT;
+}
+
+void Simulation::reset() {
+    course.clear();
+    bird.y = SCREEN_HEIGHT / 2;
+    birdVelocity = 0;
+    birdAngle = 0;
+    score = 0;
+    state = WAITING;
+    gameTime = 0;
+    playTicks = 0;
+    gameSpeed = 0.2f;
+    gravity = INITIAL_GRAVITY;
+    jumpForce = INITIAL_JUMP_FORCE;
+}
+
+void Simulation::seed(uint64_t value) {
+    course.random.reseed(value);
+    tick = 0;
+    scrollOffset = 0;
+    reset();
+}
+
+uint64_t Simulation::stateHash() const {
+    // FNV-1a по всем полям, влияющим на дальнейшую игру
+    uint64_t hash = 1469598103934665603ULL;
+    auto mix = [&hash](const void* data, size_t size) {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; i++) {
+            hash = (hash ^ bytes[i]) * 1099511628211ULL;
+        }
+    };
+    auto mixInt = [&mix](int64_t value) { mix(&value, sizeof(value)); };
+    auto mixFloat = [&mix](float value) {
+        uint32_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        mix(&bits, sizeof(bits));
+    };
+
+    mixInt(state);
+    mixInt(bird.x);
+    mixInt(bird.y);
+    mixFloat(birdVelocity);
+    mixFloat(birdAngle);
+    mixFloat(scrollOffset);
+    mixInt(score);
+    mixInt(static_cast<int64_t>(tick));
+    mixInt(playTicks);
+    mixInt(course.framesSinceLastPipe);
+    mixInt(static_cast<int64_t>(course.random.getState()));
+    for (const auto& pipe : course.pipes) {
+        mixInt(pipe.x);
+        mixInt(pipe.gapTop);
+        mixInt(pipe.gapHeight);
+        mixInt(pipe.scored);
+    }
+    return hash;
+}
+
+uint32_t Simulation::step(const Input& input) {
+    uint32_t events = EVENT_NONE;
+    tick++;
+
+    // Обработка ввода
+    if (input.flap) {
+        if (state == WAITING) {
+            state = PLAYING;
+            playTicks = 0;
+            gameTime = 0;
+            birdVelocity = 0;
+            jump(events);
+        }
+        else if (state == PLAYING) {
+            jump(events);
+        }
+        else if (state == GAME_OVER) {
+            reset();
+        }
+    }
+
+    if (state == WAITING) {
+        const double ms = tick * 1000.0 / TICKS_PER_SECOND;
+        bird.y = SCREEN_HEIGHT / 2 + sin(ms / 500.0) * 30;
+        scrollOffset -= 0.5;
+        if (scrollOffset <= -SCREEN_WIDTH) {
+            scrollOffset = 0;
+        }
+        return events;
+    }
+
+    if (state != PLAYING) {
+        return events;
+    }
+
+    playTicks++;
+    gameTime = playTicks * 1000 / TICKS_PER_SECOND;
+
+    const Rect prevBird = bird;
+
+    // Обновление физики птицы
+    birdVelocity += gravity;
+    birdVelocity = std::min(birdVelocity, MAX_FALL_SPEED);
+    bird.y += static_cast<int>(birdVelocity);
+
+    if (birdVelocity < 0) {
+        birdAngle = -25.0f;
+    } else {
+        birdAngle = std::min(birdAngle + 1.0f, 70.0f);
+    }
+
+    // Проверка столкновений со стенами
+    if (bird.y < 0) {
+        bird.y = 0;
+        birdVelocity = 0;
+    }
+
+    // Проверка столкновения с землей
+    if (bird.y + bird.h > SCREEN_HEIGHT - GROUND_HEIGHT) {
+        bird.y = SCREEN_HEIGHT - GROUND_HEIGHT - bird.h;
+        state = GAME_OVER;
+        return events | EVENT_HIT | EVENT_DIE;
+    }
+
+    // Обновление фона
+    scrollOffset -= 1.0f;
+    if (scrollOffset <= -SCREEN_WIDTH) {
+        scrollOffset = 0;
+    }
+
+    const int passed = course.advance(bird.x);
+    if (passed > 0) {
+        score += passed;
+        events |= EVENT_SCORE;
+    }
+
+    // Проверка столкновений с трубами на всём пути птицы за шаг
+    if (Collision::birdHitsPipes(prevBird, bird, course.pipes, PIPE_SPEED)) {
+        state = GAME_OVER;
+        events |= EVENT_HIT;
+    }
+    return events;
+}
+
+void Simulation::jump(uint32_t& events) {
+    if (state == PLAYING) {
+        birdVelocity = std::max(jumpForce, -4.0f);  // Добавили ограничение
+        birdAngle = -25.0f;
+        events |= EVENT_JUMP;
+    }
+}
+
+void Simulation::Course::clear() {
+    pipes.clear();
+    framesSinceLastPipe = 0;
+}
+
+void Simulation::Course::createPipe() {
+    const int maxHeight = SCREEN_HEIGHT - PIPE_GAP - PIPE_MIN_HEIGHT - GROUND_HEIGHT;
+
+    Pipe pipe;
+    pipe.x = SCREEN_WIDTH;
+    pipe.gapTop = PIPE_MIN_HEIGHT + static_cast<int>(random.bounded(maxHeight - PIPE_MIN_HEIGHT));
+    pipe.gapHeight = PIPE_GAP;
+    pipe.scored = false;
+    pipes.push_back(pipe);
+}
+
+int Simulation::Course::advance(int birdX) {
+    // Создание первой трубы, если их нет
+    if (pipes.empty()) {
+        createPipe();
+    }
+
+    framesSinceLastPipe++;
+    if (framesSinceLastPipe >= PIPE_SPAWN_INTERVAL) {
+        createPipe();
+        framesSinceLastPipe = 0;
+    }
+
+    int passed = 0;
+    for (size_t i = 0; i < pipes.size(); i++) {
+        Pipe& pipe = pipes[i];
+        pipe.x -= PIPE_SPEED;
+
+        if (!pipe.scored && birdX > pipe.x + PIPE_WIDTH) {
+            pipe.scored = true;
+            passed++;
+        }
+    }
+
+    while (!pipes.empty() && pipes.front().x + PIPE_WIDTH < 0) {
+        pipes.pop_front();
+    }
+    return passed;
+}
+
+void Simulation::updateDifficulty() {
+    float baseSpeed = 0.2f;             // Уменьшенная базовая скорость
+    float maxSpeed = 0.4f;              // Уменьшенная максимальная скорость
+    float accelerationFactor = gameTime / 240000.0f;  // Замедленное ускорение
+    float speedIncrease = std::cbrt(accelerationFactor) * 0.08f;
+
+    gameSpeed = std::min(baseSpeed + speedIncrease, maxSpeed);
+    gravity = INITIAL_GRAVITY * (1.0f + (gameSpeed - baseSpeed) * 0.02f);
+    jumpForce = INITIAL_JUMP_FORCE * (1.0f + (gameSpeed - baseSpeed) * 0.02f);
+}
@@ -0,0 +1,126 @@
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+#include <cstdint>
+#include "RingBuffer.h"
+#include "Random.h"
+
+// Правила игры без SDL: физика птицы, трубы и счёт.
+// Один вызов step() — один кадр игрового мира.
+class Simulation {
+public:
+    static const int SCREEN_WIDTH = 800;
+    static const int SCREEN_HEIGHT = 600;
+    static const int GROUND_HEIGHT = 100;
+    static const int BIRD_WIDTH = 40;
+    static const int BIRD_HEIGHT = 30;
+    static const int PIPE_WIDTH = 60;
+    static const int PIPE_GAP = 220;
+    static const int PIPE_MIN_HEIGHT = 100;
+    static const int PIPE_SPEED = 2;
+    static const int PIPE_SPAWN_INTERVAL = 180;
+    static const int MAX_PIPES = 8;  // Одновременно на экране не больше (800 + 60) / 360 + 1
+    // Скорости, гравитация и таймеры заданы на шаг, поэтому частота шагов
+    // фиксирована: другая частота изменила бы скорость игры
+    static const int TICKS_PER_SECOND = 60;
+    static constexpr float INITIAL_GRAVITY = 0.15f;
+    static constexpr float INITIAL_JUMP_FORCE = -4.0f;
+    static constexpr float MAX_FALL_SPEED = 2.5f;
+
+    enum State {
+        WAITING,
+        PLAYING,
+        GAME_OVER
+    };
+
+    // События кадра для фронтенда (звуки и т.п.)
+    enum Event : uint32_t {
+        EVENT_NONE  = 0,
+        EVENT_JUMP  = 1 << 0,
+        EVENT_SCORE = 1 << 1,
+        EVENT_HIT   = 1 << 2,
+        EVENT_DIE   = 1 << 3
+    };
+
+    struct Rect {
+        int x, y, w, h;
+    };
+
+    // Пара труб с зазором; прямоугольники вычисляются по требованию
+    struct Pipe {
+        int x;
+        int gapTop;
+        int gapHeight;
+        bool scored;
+
+        Rect topRect() const { return Rect{x, 0, PIPE_WIDTH, gapTop}; }
+        Rect bottomRect() const {
+            const int bottomY = gapTop + gapHeight;
+            return Rect{x, bottomY, PIPE_WIDTH, SCREEN_HEIGHT - GROUND_HEIGHT - bottomY};
+        }
+    };
+
+    using PipeRing = RingBuffer<Pipe, MAX_PIPES>;
+
+    // Трасса: трубы, генератор зазоров и таймер появления.
+    // Не зависит от птицы, поэтому одна трасса может обслуживать целую популяцию.
+    struct Course {
+        PipeRing pipes;
+        Random random;
+        int framesSinceLastPipe = 0;
+
+        explicit Course(uint64_t seed = 0) : random(seed) {}
+        void clear();
+        // Шаг трассы: появление, сдвиг и удаление пар труб.
+        // Возвращает число пар, правый край которых в этот шаг прошёл левее birdX.
+        int advance(int birdX);
+
+    private:
+        void createPipe();
+    };
+
+    struct Input {
+        bool flap = false;
+    };
+
+    explicit Simulation(uint64_t seed = 0);
+
+    // Возвращает маску Event, произошедших за кадр
+    uint32_t step(const Input& input);
+    void reset();
+    // Новая сессия с нуля: тот же seed и те же входы дают тот же результат
+    void seed(uint64_t value);
+    // Хэш полного состояния мира для сверки повторов
+    uint64_t stateHash() const;
+
+    State getState() const { return state; }
+    const Rect& getBird() const { return bird; }
+    float getBirdVelocity() const { return birdVelocity; }
+    float getBirdAngle() const { return birdAngle; }
+    float getScrollOffset() const { return scrollOffset; }
+    int getScore() const { return score; }
+    uint32_t getGameTime() const { return gameTime; }
+    uint64_t getTick() const { return tick; }
+    const PipeRing& getPipes() const { return course.pipes; }
+
+private:
+    Rect bird;
+    Course course;
+
+    State state;
+    float birdVelocity;
+    float birdAngle;
+    int score;
+    float scrollOffset;
+    uint32_t gameTime;
+    uint64_t tick;
+    uint32_t playTicks;
+    float gameSpeed;
+    float gravity;
+    float jumpForce;
+
+    void jump(uint32_t& events);
+    void updateDifficulty();
+};
+
+#endif // SIMULATION_H
@@ -0,0 +1,73 @@
+#include "SpriteBatch.h"
+#include <cmath>
+
+void SpriteBatch::reserve(size_t sprites) {
+    vertices.reserve(sprites * 4);
+    indices.reserve(sprites * 6);
+}
+
+void SpriteBatch::begin(SDL_Texture* texture, int textureWidth, int textureHeight) {
+    this->texture = texture;
+    invWidth = textureWidth > 0 ? 1.0f / textureWidth : 0.0f;
+    invHeight = textureHeight > 0 ? 1.0f / textureHeight : 0.0f;
+    vertices.clear();
+    indices.clear();
+}
+
+void SpriteBatch::draw(const SDL_Rect& src, const SDL_FRect& dst, SDL_Color color) {
+    const SDL_FPoint corners[4] = {
+        {dst.x, dst.y},
+        {dst.x + dst.w, dst.y},
+        {dst.x + dst.w, dst.y + dst.h},
+        {dst.x, dst.y + dst.h}
+    };
+    pushQuad(src, corners, color);
+}
+
+void SpriteBatch::drawRotated(const SDL_Rect& src, const SDL_FRect& dst, double angle, SDL_Color color) {
+    const float radians = static_cast<float>(angle * M_PI / 180.0);
+    const float c = std::cos(radians);
+    const float s = std::sin(radians);
+    const float cx = dst.x + dst.w * 0.5f;
+    const float cy = dst.y + dst.h * 0.5f;
+    const float hw = dst.w * 0.5f;
+    const float hh = dst.h * 0.5f;
+
+    const float offsets[4][2] = {{-hw, -hh}, {hw, -hh}, {hw, hh}, {-hw, hh}};
+    SDL_FPoint corners[4];
+    for (int i = 0; i < 4; i++) {
+        corners[i].x = cx + offsets[i][0] * c - offsets[i][1] * s;
+        corners[i].y = cy + offsets[i][0] * s + offsets[i][1] * c;
+    }
+    pushQuad(src, corners, color);
+}
+
+void SpriteBatch::pushQuad(const SDL_Rect& src, const SDL_FPoint corners[4], SDL_Color color) {
+    const float u0 = src.x * invWidth;
+    const float v0 = src.y * invHeight;
+    const float u1 = (src.x + src.w) * invWidth;
+    const float v1 = (src.y + src.h) * invHeight;
+    const SDL_FPoint uvs[4] = {{u0, v0}, {u1, v0}, {u1, v1}, {u0, v1}};
+
+    const int base = static_cast<int>(vertices.size());
+    for (int i = 0; i < 4; i++) {
+        vertices.push_back(SDL_Vertex{corners[i], color, uvs[i]});
+    }
+    const int quadIndices[6] = {0, 1, 2, 2, 3, 0};
+    for (int index : quadIndices) {
+        indices.push_back(base + index);
+    }
+}
+
+void SpriteBatch::end(SDL_Renderer* renderer, RenderStats& stats) {
+    if (vertices.empty()) {
+        return;
+    }
+
+    SDL_RenderGeometry(renderer, texture,
+                       vertices.data(), static_cast<int>(vertices.size()),
+                       indices.data(), static_cast<int>(indices.size()));
+    stats.drawCalls++;
+    stats.textureSwitches++;
+    stats.sprites += static_cast<int>(vertices.size() / 4);
+}
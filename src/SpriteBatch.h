@@ -0,0 +1,43 @@
+#ifndef SPRITE_BATCH_H
+#define SPRITE_BATCH_H
+
+#include <SDL.h>
+#include <vector>
+
+// Счётчики отрисовки за кадр
+struct RenderStats {
+    int drawCalls = 0;
+    int textureSwitches = 0;
+    int sprites = 0;
+    int textureUploads = 0;
+    int repaintedPixels = 0;        // Пиксели кадра, которые рендерер перерисовал
+};
+
+// Накопление спрайтов одной текстуры (атласа) в общий буфер вершин/индексов
+// и отправка их одним вызовом SDL_RenderGeometry
+class SpriteBatch {
+public:
+    static constexpr SDL_Color WHITE = {255, 255, 255, 255};
+
+    // Выделяет память под sprites спрайтов заранее, чтобы буферы не росли во время кадров
+    void reserve(size_t sprites);
+    void begin(SDL_Texture* texture, int textureWidth, int textureHeight);
+    // color умножается на цвет текстуры, как SDL_SetTextureColorMod/AlphaMod
+    void draw(const SDL_Rect& src, const SDL_FRect& dst, SDL_Color color = WHITE);
+    // Поворот по часовой стрелке вокруг центра dst, как у SDL_RenderCopyEx
+    void drawRotated(const SDL_Rect& src, const SDL_FRect& dst, double angle, SDL_Color color = WHITE);
+    // Отправляет накопленные спрайты; можно вызвать повторно, например по разу
+    // на каждую область отсечения, — буфер очищает только begin()
+    void end(SDL_Renderer* renderer, RenderStats& stats);
+
+private:
+    SDL_Texture* texture = nullptr;
+    float invWidth = 0.0f;
+    float invHeight = 0.0f;
+    std::vector<SDL_Vertex> vertices;
+    std::vector<int> indices;
+
+    void pushQuad(const SDL_Rect& src, const SDL_FPoint corners[4], SDL_Color color);
+};
+
+#endif // SPRITE_BATCH_H
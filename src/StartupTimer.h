@@ -0,0 +1,95 @@
+#ifndef STARTUP_TIMER_H
+#define STARTUP_TIMER_H
+
+#include <algorithm>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <vector>
+#include "Profiler.h"
+
+// Временная шкала запуска: этапы из любых потоков с началом, длительностью
+// и номером потока. При включённом профилировщике этапы попадают и в trace.
+class StartupTimer {
+public:
+    // Этап длится до выхода из области видимости; name должен жить до report()
+    class Scope {
+    public:
+        Scope(StartupTimer& timer, const char* name) :
+            timer(timer),
+            name(name),
+            start(Profiler::nowUs())
+        {
+        }
+
+        ~Scope() {
+            timer.record(name, start, Profiler::nowUs());
+        }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        StartupTimer& timer;
+        const char* name;
+        uint64_t start;
+    };
+
+    StartupTimer() : origin(Profiler::nowUs()), finished(0) {}
+
+    void record(const char* name, uint64_t startUs, uint64_t endUs) {
+        if (Profiler::instance().isEnabled()) {
+            Profiler::instance().record(name, startUs, endUs - startUs);
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        steps.push_back(Step{name, startUs - origin, endUs - startUs, Profiler::threadIndex()});
+    }
+
+    // Отметка без длительности, например первый показанный кадр
+    void mark(const char* name) {
+        const uint64_t now = Profiler::nowUs();
+        record(name, now, now);
+    }
+
+    // Конец запуска — первый кадр игры
+    void finish() { finished = Profiler::nowUs() - origin; }
+    uint64_t totalUs() const { return finished; }
+
+    void report(std::ostream& out) const {
+        std::vector<Step> sorted;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            sorted = steps;
+        }
+        std::stable_sort(sorted.begin(), sorted.end(), [](const Step& a, const Step& b) {
+            return a.start < b.start;
+        });
+
+        const std::ios::fmtflags flags = out.flags();
+        out << std::fixed << std::setprecision(1)
+            << "Startup: " << finished / 1000.0 << " ms to first game frame" << std::endl
+            << "      start   duration  thread  step" << std::endl;
+        for (const auto& step : sorted) {
+            out << std::setw(9) << step.start / 1000.0 << " ms"
+                << std::setw(8) << step.duration / 1000.0 << " ms"
+                << std::setw(8) << step.thread << "  " << step.name << std::endl;
+        }
+        out.flags(flags);
+    }
+
+private:
+    struct Step {
+        const char* name;
+        uint64_t start;
+        uint64_t duration;
+        uint32_t thread;
+    };
+
+    uint64_t origin;
+    uint64_t finished;
+    mutable std::mutex mutex;
+    std::vector<Step> steps;
+};
+
+#endif // STARTUP_TIMER_H
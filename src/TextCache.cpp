@@ -0,0 +1,80 @@
+#include "TextCache.h"
+
+TextCache::TextCache(size_t capacity) :
+    renderer(nullptr),
+    font(nullptr),
+    capacity(capacity),
+    useCounter(0)
+{
+    keyBuffer.reserve(64);
+}
+
+TextCache::~TextCache() {
+    clear();
+}
+
+void TextCache::init(SDL_Renderer* renderer, TTF_Font* font) {
+    clear();
+    this->renderer = renderer;
+    this->font = font;
+}
+
+const TextCache::Entry* TextCache::get(const char* text, SDL_Color color) {
+    // Ключ: 4 байта цвета + сама строка; буфер переиспользуется между вызовами
+    keyBuffer.clear();
+    keyBuffer.push_back(static_cast<char>(color.r));
+    keyBuffer.push_back(static_cast<char>(color.g));
+    keyBuffer.push_back(static_cast<char>(color.b));
+    keyBuffer.push_back(static_cast<char>(color.a));
+    keyBuffer += text;
+
+    auto it = entries.find(keyBuffer);
+    if (it != entries.end()) {
+        stats.hits++;
+        it->second.lastUsed = ++useCounter;
+        return &it->second;
+    }
+
+    stats.misses++;
+    if (!renderer || !font) {
+        return nullptr;
+    }
+
+    SDL_Surface* surface = TTF_RenderText_Blended(font, text, color);
+    if (!surface) {
+        return nullptr;
+    }
+
+    SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
+    Entry entry = {texture, surface->w, surface->h, ++useCounter};
+    SDL_FreeSurface(surface);
+    if (!texture) {
+        return nullptr;
+    }
+
+    if (entries.size() >= capacity) {
+        evictOldest();
+    }
+    return &entries.emplace(keyBuffer, entry).first->second;
+}
+
+void TextCache::evictOldest() {
+    auto oldest = entries.end();
+    for (auto it = entries.begin(); it != entries.end(); ++it) {
+        if (oldest == entries.end() || it->second.lastUsed < oldest->second.lastUsed) {
+            oldest = it;
+        }
+    }
+    if (oldest != entries.end()) {
+        SDL_DestroyTexture(oldest->second.texture);
+        entries.erase(oldest);
+        stats.evictions++;
+    }
+}
+
+void TextCache::clear() {
+    for (auto& [key, entry] : entries) {
+        SDL_DestroyTexture(entry.texture);
+    }
+    entries.clear();
+}
@@ -0,0 +1,50 @@
+#ifndef TEXT_CACHE_H
+#define TEXT_CACHE_H
+
+#include <SDL.h>
+#include <SDL_ttf.h>
+#include <string>
+#include <unordered_map>
+#include <cstdint>
+
+// Кэш текстур строк: строка растеризуется и загружается в GPU только
+// при первом появлении, дальше рисуется готовая текстура
+class TextCache {
+public:
+    struct Stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;
+    };
+
+    struct Entry {
+        SDL_Texture* texture;
+        int w;
+        int h;
+        uint64_t lastUsed;
+    };
+
+    explicit TextCache(size_t capacity = 64);
+    ~TextCache();
+
+    void init(SDL_Renderer* renderer, TTF_Font* font);
+    // Возвращает nullptr, если растеризация не удалась
+    const Entry* get(const char* text, SDL_Color color);
+    void clear();
+
+    const Stats& getStats() const { return stats; }
+    size_t size() const { return entries.size(); }
+
+private:
+    SDL_Renderer* renderer;
+    TTF_Font* font;
+    size_t capacity;
+    uint64_t useCounter;
+    Stats stats;
+    std::unordered_map<std::string, Entry> entries;
+    std::string keyBuffer;
+
+    void evictOldest();
+};
+
+#endif // TEXT_CACHE_H
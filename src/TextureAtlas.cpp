@@ -0,0 +1,140 @@
+#include "TextureAtlas.h"
+#include <algorithm>
+#include <iostream>
+#include <numeric>
+
+TextureAtlas::TextureAtlas() :
+    texture(nullptr),
+    width(0),
+    height(0)
+{
+}
+
+TextureAtlas::~TextureAtlas() {
+    destroy();
+}
+
+int TextureAtlas::add(SDL_Surface* surface, int maxWidth, int maxHeight) {
+    return addPrepared(prepare(surface, maxWidth, maxHeight));
+}
+
+SDL_Surface* TextureAtlas::prepare(SDL_Surface* surface, int maxWidth, int maxHeight) {
+    if (!surface) {
+        return nullptr;
+    }
+
+    SDL_Surface* converted = SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_ARGB8888, 0);
+    if (!converted) {
+        std::cout << "Failed to convert atlas sprite: " << SDL_GetError() << std::endl;
+        return nullptr;
+    }
+
+    // Уменьшаем по каждой оси до размера, в котором спрайт реально рисуется
+    const int w = std::min(converted->w, maxWidth);
+    const int h = std::min(converted->h, maxHeight);
+    if (w != converted->w || h != converted->h) {
+        SDL_Surface* scaled = SDL_CreateRGBSurfaceWithFormat(0, w, h, 32, SDL_PIXELFORMAT_ARGB8888);
+        if (!scaled || SDL_SoftStretchLinear(converted, nullptr, scaled, nullptr) < 0) {
+            std::cout << "Failed to scale atlas sprite: " << SDL_GetError() << std::endl;
+            SDL_FreeSurface(scaled);
+            SDL_FreeSurface(converted);
+            return nullptr;
+        }
+        SDL_FreeSurface(converted);
+        converted = scaled;
+    }
+    return converted;
+}
+
+int TextureAtlas::addPrepared(SDL_Surface* surface) {
+    if (!surface) {
+        return -1;
+    }
+    pending.push_back(surface);
+    regions.push_back(SDL_Rect{0, 0, surface->w, surface->h});
+    return static_cast<int>(regions.size()) - 1;
+}
+
+bool TextureAtlas::build(SDL_Renderer* renderer) {
+    if (pending.empty()) {
+        return false;
+    }
+
+    std::vector<int> order(pending.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [this](int a, int b) {
+        return regions[a].h > regions[b].h;
+    });
+
+    // Ширина атласа — степень двойки, не меньше самого широкого спрайта и корня из суммарной площади
+    long long area = 0;
+    int widest = 0;
+    for (const auto& region : regions) {
+        area += static_cast<long long>(region.w + PADDING) * (region.h + PADDING);
+        widest = std::max(widest, region.w + PADDING);
+    }
+    width = 1;
+    while (width < widest || static_cast<long long>(width) * width < area) {
+        width *= 2;
+    }
+
+    // Раскладка полками
+    int x = 0, y = 0, shelfHeight = 0;
+    for (int id : order) {
+        SDL_Rect& region = regions[id];
+        if (x + region.w + PADDING > width) {
+            x = 0;
+            y += shelfHeight;
+            shelfHeight = 0;
+        }
+        region.x = x;
+        region.y = y;
+        x += region.w + PADDING;
+        shelfHeight = std::max(shelfHeight, region.h + PADDING);
+    }
+    height = 1;
+    while (height < y + shelfHeight) {
+        height *= 2;
+    }
+
+    SDL_Surface* atlas = SDL_CreateRGBSurfaceWithFormat(0, width, height, 32, SDL_PIXELFORMAT_ARGB8888);
+    if (!atlas) {
+        std::cout << "Failed to create atlas surface: " << SDL_GetError() << std::endl;
+        freePending();
+        return false;
+    }
+    SDL_FillRect(atlas, nullptr, 0);
+    for (size_t i = 0; i < pending.size(); i++) {
+        SDL_SetSurfaceBlendMode(pending[i], SDL_BLENDMODE_NONE);
+        SDL_Rect dst = regions[i];
+        SDL_BlitSurface(pending[i], nullptr, atlas, &dst);
+    }
+    freePending();
+
+    texture = SDL_CreateTextureFromSurface(renderer, atlas);
+    SDL_FreeSurface(atlas);
+    if (!texture) {
+        std::cout << "Failed to create atlas texture " << width << "x" << height << ": " << SDL_GetError() << std::endl;
+        return false;
+    }
+    SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+    return true;
+}
+
+void TextureAtlas::freePending() {
+    for (SDL_Surface* surface : pending) {
+        SDL_FreeSurface(surface);
+    }
+    pending.clear();
+}
+
+void TextureAtlas::destroy() {
+    freePending();
+    regions.clear();
+    if (texture) {
+        SDL_DestroyTexture(texture);
+        texture = nullptr;
+    }
+    width = 0;
+    height = 0;
+}
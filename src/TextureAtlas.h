@@ -0,0 +1,41 @@
+#ifndef TEXTURE_ATLAS_H
+#define TEXTURE_ATLAS_H
+
+#include <SDL.h>
+#include <vector>
+
+// Упаковка нескольких спрайтов в одну текстуру (полками, по убыванию высоты).
+// Спрайты крупнее нужного на экране уменьшаются при добавлении.
+class TextureAtlas {
+public:
+    static const int PADDING = 2;
+
+    TextureAtlas();
+    ~TextureAtlas();
+
+    // Возвращает id региона или -1. Поверхность копируется, владение остаётся у вызывающего
+    int add(SDL_Surface* surface, int maxWidth, int maxHeight);
+    // Приведение к формату атласа и нужному размеру; не трогает атлас и рендерер,
+    // поэтому может выполняться в фоновом потоке. Возвращает новую поверхность или nullptr
+    static SDL_Surface* prepare(SDL_Surface* surface, int maxWidth, int maxHeight);
+    // Добавляет уже подготовленную поверхность и забирает владение ею
+    int addPrepared(SDL_Surface* surface);
+    bool build(SDL_Renderer* renderer);
+    void destroy();
+
+    SDL_Texture* getTexture() const { return texture; }
+    const SDL_Rect& getRegion(int id) const { return regions[id]; }
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+
+private:
+    SDL_Texture* texture;
+    int width;
+    int height;
+    std::vector<SDL_Surface*> pending;
+    std::vector<SDL_Rect> regions;
+
+    void freePending();
+};
+
+#endif // TEXTURE_ATLAS_H
@@ -0,0 +1,109 @@
+#include "ThreadPool.h"
+#include <algorithm>
+
+namespace {
+// Индекс рабочего потока текущего пула, чтобы вложенные задачи шли в свою очередь
+thread_local const void* currentPool = nullptr;
+thread_local unsigned currentWorker = 0;
+}
+
+ThreadPool::ThreadPool(unsigned threads) :
+    queued(0),
+    unfinished(0),
+    nextWorker(0),
+    stopping(false)
+{
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    for (unsigned i = 0; i < threads; i++) {
+        workers.push_back(std::make_unique<Worker>());
+    }
+    for (unsigned i = 0; i < threads; i++) {
+        workers[i]->thread = std::thread(&ThreadPool::run, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    wait();
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    wakeCondition.notify_all();
+    for (auto& worker : workers) {
+        worker->thread.join();
+    }
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+    const unsigned index = currentPool == this
+        ? currentWorker
+        : nextWorker.fetch_add(1, std::memory_order_relaxed) % size();
+
+    unfinished.fetch_add(1);
+    {
+        // Под мьютексом сна, чтобы поток не пропустил пробуждение между проверкой и ожиданием.
+        // Счётчик растёт до вставки, поэтому никогда не уходит в минус
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        queued.fetch_add(1);
+    }
+    {
+        std::lock_guard<std::mutex> lock(workers[index]->mutex);
+        workers[index]->tasks.push_back(std::move(task));
+    }
+    wakeCondition.notify_one();
+}
+
+void ThreadPool::wait() {
+    std::unique_lock<std::mutex> lock(sleepMutex);
+    doneCondition.wait(lock, [this] { return unfinished.load() == 0; });
+}
+
+bool ThreadPool::takeTask(unsigned index, std::function<void()>& task) {
+    // Сначала своя очередь с конца (свежие задачи, горячий кэш)
+    {
+        Worker& own = *workers[index];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            return true;
+        }
+    }
+    // Затем кража из начала чужих очередей
+    for (unsigned offset = 1; offset < size(); offset++) {
+        Worker& victim = *workers[(index + offset) % size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::run(unsigned index) {
+    currentPool = this;
+    currentWorker = index;
+
+    for (;;) {
+        std::function<void()> task;
+        if (takeTask(index, task)) {
+            queued.fetch_sub(1);
+            task();
+            if (unfinished.fetch_sub(1) == 1) {
+                std::lock_guard<std::mutex> lock(sleepMutex);
+                doneCondition.notify_all();
+            }
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        wakeCondition.wait(lock, [this] { return stopping || queued.load() > 0; });
+        if (stopping && queued.load() == 0) {
+            return;
+        }
+    }
+}
@@ -0,0 +1,50 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Пул потоков с кражей работы: у каждого потока своя очередь, задачи
+// берутся с её конца, а простаивающий поток забирает начало чужой очереди
+class ThreadPool {
+public:
+    // threads == 0 — по числу аппаратных потоков
+    explicit ThreadPool(unsigned threads = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void submit(std::function<void()> task);
+    // Ждёт завершения всех отправленных задач
+    void wait();
+    unsigned size() const { return static_cast<unsigned>(workers.size()); }
+
+private:
+    struct Worker {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+        std::thread thread;
+    };
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::atomic<size_t> queued;
+    std::atomic<size_t> unfinished;
+    std::atomic<unsigned> nextWorker;
+    bool stopping;
+
+    std::mutex sleepMutex;
+    std::condition_variable wakeCondition;
+    std::condition_variable doneCondition;
+
+    void run(unsigned index);
+    bool takeTask(unsigned index, std::function<void()>& task);
+};
+
+#endif // THREAD_POOL_H
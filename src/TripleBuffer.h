@@ -0,0 +1,46 @@
+#ifndef TRIPLE_BUFFER_H
+#define TRIPLE_BUFFER_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+// Тройной буфер без блокировок для одного писателя и одного читателя.
+// Писатель заполняет свой слот и обменивает его со средним, читатель забирает
+// средний, только если там появились новые данные. Ни одна сторона не ждёт
+// другую; читатель всегда видит последний целиком записанный снимок.
+template <typename T>
+class TripleBuffer {
+public:
+    TripleBuffer() : back(0), middle(1), front(2) {}
+
+    // Слот писателя; после заполнения — publish()
+    T& writeBuffer() { return slots[back]; }
+
+    void publish() {
+        back = middle.exchange(static_cast<uint8_t>(back | FRESH), std::memory_order_acq_rel) & INDEX_MASK;
+    }
+
+    // Забирает свежий снимок, если он есть; возвращает true, если снимок сменился
+    bool update() {
+        if (!(middle.load(std::memory_order_relaxed) & FRESH)) {
+            return false;
+        }
+        front = middle.exchange(front, std::memory_order_acq_rel) & INDEX_MASK;
+        return true;
+    }
+
+    // Слот читателя: последний полученный через update() снимок
+    const T& readBuffer() const { return slots[front]; }
+
+private:
+    static const uint8_t INDEX_MASK = 0x3;
+    static const uint8_t FRESH = 0x4;
+
+    std::array<T, 3> slots;
+    uint8_t back;
+    std::atomic<uint8_t> middle;
+    uint8_t front;
+};
+
+#endif // TRIPLE_BUFFER_H
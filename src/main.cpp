@@ -1,18 +1,469 @@
 #include "Game.h"
+#include "Simulation.h"
+#include "Autopilot.h"
+#include "Replay.h"
+#include "BatchRunner.h"
+#include "Profiler.h"
+#include "FrameLimiter.h"
+#include "FrameCapture.h"
+#include "AllocationCounter.h"
+#include "ScoreStore.h"
+#include "EnvServer.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+// Прогон симуляции без окна и звука под управлением автопилота
+static int runHeadless(long long frames) {
+    Simulation sim(static_cast<uint64_t>(time(nullptr)));
+    long long games = 0;
+    long long totalScore = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (long long i = 0; i < frames; i++) {
+        if (sim.getState() == Simulation::GAME_OVER) {
+            games++;
+            totalScore += sim.getScore();
+        }
+        sim.step(autopilot(sim));
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "Frames: " << frames << ", games: " << games
+              << ", avg score: " << (games ? static_cast<double>(totalScore) / games : 0.0)
+              << ", current score: " << sim.getScore()
+              << ", frames/s: " << static_cast<long long>(frames / std::max(seconds, 1e-9)) << std::endl;
+    return 0;
+}
+
+// Проверка записанных сессий: пересимуляция без SDL со сверкой счёта и хэша
+static int runReplays(const std::vector<std::string>& paths) {
+    int failed = 0;
+    uint64_t totalTicks = 0;
+    double simulatedSeconds = 0.0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (const auto& path : paths) {
+        Replay replay;
+        if (!replay.load(path)) {
+            failed++;
+            continue;
+        }
+        ReplayCheck check = verifyReplay(replay);
+        totalTicks += check.ticks;
+        simulatedSeconds += static_cast<double>(check.ticks) / std::max<uint16_t>(replay.tickRate, 1);
+        if (!check.matches) {
+            failed++;
+            std::cout << "MISMATCH " << path << ": score " << check.score << " (recorded " << replay.finalScore
+                      << "), hash " << std::hex << check.hash << " (recorded " << replay.finalHash << ")"
+                      << std::dec << std::endl;
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "Replays: " << paths.size() << ", failed: " << failed << ", ticks: " << totalTicks
+              << ", speed: " << static_cast<long long>(simulatedSeconds / std::max(seconds, 1e-9))
+              << "x real-time" << std::endl;
+    return failed == 0 ? 0 : 1;
+}
+
+// Пакетная оценка агента (здесь — автопилота) на всех ядрах
+static int runBatchMode(const BatchConfig& config) {
+    BatchResult result = runBatch(config, autopilot);
+    std::cout << "Episodes: " << result.episodes << " on " << result.threads << " threads"
+              << ", score mean/min/max: " << result.meanScore << "/" << result.minScore << "/" << result.maxScore
+              << ", episodes/s: " << static_cast<long long>(result.episodesPerSecond)
+              << ", ticks/s: " << static_cast<long long>(result.ticksPerSecond) << std::endl;
+    return 0;
+}
+
+// Запись сессии в кадры: повтор проигрывается без окна со скоростью рендеринга,
+// каждый шаг симуляции даёт один кадр
+static int runCapture(const std::string& replayPath, const std::string& directory, FrameCapture::Format format) {
+    Replay replay;
+    if (!replay.load(replayPath)) {
+        return 1;
+    }
+
+    SDL_SetHint(SDL_HINT_VIDEODRIVER, "dummy");
+    SDL_SetHint(SDL_HINT_AUDIODRIVER, "dummy");
+    Game game;
+    game.setOffscreen(true);
+    game.setSeed(replay.seed);
+    if (!game.init()) {
+        return 1;
+    }
+
+    FrameCapture capture;
+    if (!capture.start(directory, format, Game::SCREEN_WIDTH, Game::SCREEN_HEIGHT)) {
+        return 1;
+    }
+
+    const Simulation& sim = game.getSimulation();
+    size_t next = 0;
+    double loopSeconds = 0.0;
+    bool ok = true;
+    auto start = std::chrono::steady_clock::now();
+    while (ok && sim.getTick() < replay.finalTick) {
+        if (next < replay.flapTicks.size() && replay.flapTicks[next] == sim.getTick() + 1) {
+            game.queueFlap();
+            next++;
+        }
+        auto frameStart = std::chrono::steady_clock::now();
+        game.update();
+        game.render(1.0f);
+        loopSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - frameStart).count();
+        ok = capture.capture(game.getRenderer());
+    }
+    capture.finish();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    const FrameCapture::Stats& stats = capture.getStats();
+    std::cout << "Captured " << stats.frames << " frames to " << directory
+              << ", capture fps: " << static_cast<long long>(stats.frames / std::max(seconds, 1e-9))
+              << ", render fps: " << static_cast<long long>(stats.frames / std::max(loopSeconds, 1e-9))
+              << ", readback: " << (stats.frames ? stats.readbackMs / stats.frames : 0.0) << " ms/frame"
+              << ", stalls: " << stats.stalls << std::endl;
+    if (format == FrameCapture::FORMAT_RAW) {
+        std::cout << "Encode with: cat " << directory << "/frame_*.raw | ffmpeg -f rawvideo -pixel_format bgra"
+                  << " -video_size " << Game::SCREEN_WIDTH << "x" << Game::SCREEN_HEIGHT
+                  << " -framerate " << replay.tickRate << " -i - out.mp4" << std::endl;
+    }
+    game.clean();
+    return ok && sim.getScore() == replay.finalScore ? 0 : 1;
+}
+
+// Проверка, что установившаяся игра не выделяет память в кадре: автопилот играет
+// без окна, после разогрева считаются выделения в каждом кадре. В конце автопилот
+// перестаёт махать, и в проверку попадает кадр, записывающий забег во временную
+// таблицу результатов, и экран конца игры. Код возврата 1 — хотя бы один кадр выделял память
+static int runAllocationCheck(long long frames, uint64_t seed) {
+    const long long warmupFrames = 2 * Simulation::PIPE_SPAWN_INTERVAL;
+    const long long gameOverFrames = 60;
+    if (!AllocationCounter::isEnabled()) {
+        std::cout << "Allocation counter is disabled; rebuild with -DFLAPPY_COUNT_ALLOCATIONS=ON" << std::endl;
+        return 1;
+    }
+    AllocationCounter::hookSdl();
+
+    SDL_SetHint(SDL_HINT_VIDEODRIVER, "dummy");
+    SDL_SetHint(SDL_HINT_AUDIODRIVER, "dummy");
+    const std::filesystem::path scoreLog = std::filesystem::temp_directory_path() / "flappy_alloc_check.log";
+    std::error_code error;
+    std::filesystem::remove(scoreLog, error);
+    std::filesystem::remove(std::filesystem::path(scoreLog).replace_extension(".idx"), error);
+
+    Game game;
+    game.setOffscreen(true);
+    game.setSeed(seed);
+    game.setScoreLog(scoreLog.string());
+    if (!game.init()) {
+        return 1;
+    }
+
+    long long checkedFrames = 0;
+    long long allocatingFrames = 0;
+    long long gameOverSeen = 0;
+    uint64_t allocations = 0;
+    uint64_t bytes = 0;
+    uint64_t maxPerFrame = 0;
+    for (long long i = 0; i < warmupFrames + frames || gameOverSeen < gameOverFrames; i++) {
+        const AllocationCounter::Counts before = AllocationCounter::get();
+        const bool falling = i >= warmupFrames + frames;
+        if (!falling && autopilot(game.getSimulation()).flap) {
+            game.queueFlap();
+        }
+        game.handleEvents();
+        game.update();
+        game.render(1.0f);
+        const AllocationCounter::Counts after = AllocationCounter::get();
+        if (falling && game.getSimulation().getState() == Simulation::GAME_OVER) {
+            gameOverSeen++;
+        }
+
+        const uint64_t count = after.allocations - before.allocations;
+        checkedFrames += i >= warmupFrames;
+        if (i < warmupFrames || count == 0) {
+            continue;
+        }
+        if (allocatingFrames < 10) {
+            std::cout << "Frame " << i << ": " << count << " allocations, "
+                      << after.bytes - before.bytes << " bytes" << std::endl;
+        }
+        allocatingFrames++;
+        allocations += count;
+        bytes += after.bytes - before.bytes;
+        maxPerFrame = std::max(maxPerFrame, count);
+    }
+
+    std::cout << "Steady-state frames: " << checkedFrames << ", allocating frames: " << allocatingFrames
+              << ", allocations: " << allocations << " (" << bytes << " bytes, max " << maxPerFrame
+              << " per frame), final score " << game.getSimulation().getScore() << std::endl;
+    game.clean();
+    std::filesystem::remove(scoreLog, error);
+    std::filesystem::remove(std::filesystem::path(scoreLog).replace_extension(".idx"), error);
+    return allocatingFrames == 0 ? 0 : 1;
+}
+
+// Сводка таблицы результатов: лучшие забеги и распределение счёта
+static int runScores(size_t count) {
+    ScoreStore scores;
+    if (!scores.open(Game::SCORE_LOG_PATH)) {
+        return 1;
+    }
+    std::cout << "Runs: " << scores.size() << ", cabinet " << scores.getCabinet() << std::endl;
+    ScoreStore::Record best;
+    if (scores.personalBest(best)) {
+        std::cout << "Personal best: " << best.score << " (seed " << best.seed << ")" << std::endl;
+    }
+
+    std::vector<ScoreStore::Record> top(std::min(count, ScoreStore::TOP_CAPACITY));
+    top.resize(scores.top(top.data(), top.size()));
+    for (size_t i = 0; i < top.size(); i++) {
+        std::cout << i + 1 << ". " << top[i].score << "  " << top[i].durationMs / 1000.0 << " s  seed "
+                  << top[i].seed << "  cabinet " << top[i].cabinet << std::endl;
+    }
+    for (int score : {1, 5, 10, 25, 50, 100}) {
+        std::cout << "Score " << score << " beats " << scores.fractionBelow(score) * 100.0 << "% of runs" << std::endl;
+    }
+    return 0;
+}
+
+// Слияние журналов с других автоматов в локальную таблицу
+static int runMergeScores(const std::vector<std::string>& paths) {
+    ScoreStore scores;
+    if (!scores.open(Game::SCORE_LOG_PATH)) {
+        return 1;
+    }
+    int failures = 0;
+    for (const auto& path : paths) {
+        uint64_t added = 0;
+        auto start = std::chrono::steady_clock::now();
+        if (!scores.merge(path, &added)) {
+            std::cout << "Failed to merge " << path << std::endl;
+            failures++;
+            continue;
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << path << ": " << added << " runs merged in " << seconds << " s" << std::endl;
+    }
+    std::cout << "Runs: " << scores.size() << std::endl;
+    return failures == 0 ? 0 : 1;
+}
+
+// Сервер сред для обучения: шаги по локальному сокету, наблюдения в общей памяти
+static int runEnvServer(const EnvServerConfig& config) {
+    EnvServer server;
+    if (!server.start(config)) {
+        return 1;
+    }
+    return server.run() ? 0 : 1;
+}
 
 int main(int argc, char* argv[]) {
+    const char* tracePath = nullptr;
+    const char* recordPath = nullptr;
+    const char* seedArg = nullptr;
+    const char* captureReplay = nullptr;
+    const char* captureDir = nullptr;
+    FrameCapture::Format captureFormat = FrameCapture::FORMAT_RAW;
+    std::vector<std::string> replayPaths;
+    std::vector<std::string> ghostPaths;
+    BatchConfig batchConfig;
+    bool batchMode = false;
+    EnvServerConfig serverConfig;
+    bool pipelined = false;
+    bool lowLatency = false;
+    int targetFps = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--headless") == 0) {
+            long long frames = (i + 1 < argc) ? atoll(argv[i + 1]) : 1000000;
+            return runHeadless(frames);
+        }
+        else if (strcmp(argv[i], "--alloc-check") == 0) {
+            long long frames = (i + 1 < argc) ? atoll(argv[i + 1]) : 3600;
+            return runAllocationCheck(frames, seedArg ? strtoull(seedArg, nullptr, 10) : 1);
+        }
+        else if (strcmp(argv[i], "--scores") == 0) {
+            const long long count = (i + 1 < argc) ? atoll(argv[i + 1]) : 0;
+            return runScores(count > 0 ? static_cast<size_t>(count) : 10);
+        }
+        else if (strcmp(argv[i], "--merge-scores") == 0) {
+            std::vector<std::string> paths;
+            while (i + 1 < argc && strncmp(argv[i + 1], "--", 2) != 0) {
+                paths.push_back(argv[++i]);
+            }
+            return runMergeScores(paths);
+        }
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seedArg = argv[++i];
+            batchConfig.seed = strtoull(seedArg, nullptr, 10);
+            serverConfig.seed = batchConfig.seed;
+        }
+        else if (strcmp(argv[i], "--batch") == 0 && i + 1 < argc) {
+            batchMode = true;
+            batchConfig.episodes = strtoull(argv[++i], nullptr, 10);
+        }
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            batchConfig.threads = static_cast<unsigned>(atoi(argv[++i]));
+            serverConfig.threads = batchConfig.threads;
+        }
+        else if (strcmp(argv[i], "--max-ticks") == 0 && i + 1 < argc) {
+            batchConfig.maxTicksPerEpisode = strtoull(argv[++i], nullptr, 10);
+            serverConfig.maxTicksPerEpisode = batchConfig.maxTicksPerEpisode;
+        }
+        else if (strcmp(argv[i], "--serve") == 0 && i + 1 < argc) {
+            serverConfig.socketPath = argv[++i];
+        }
+        else if (strcmp(argv[i], "--envs") == 0 && i + 1 < argc) {
+            serverConfig.envCount = static_cast<uint32_t>(std::max(1, atoi(argv[++i])));
+        }
+        else if (strcmp(argv[i], "--obs-frame") == 0 && i + 2 < argc) {
+            serverConfig.frameWidth = static_cast<uint32_t>(std::max(0, atoi(argv[++i])));
+            serverConfig.frameHeight = static_cast<uint32_t>(std::max(0, atoi(argv[++i])));
+        }
+        else if (strcmp(argv[i], "--obs-stack") == 0 && i + 1 < argc) {
+            serverConfig.frameStack = static_cast<uint32_t>(std::max(1, atoi(argv[++i])));
+        }
+        else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+            recordPath = argv[++i];
+        }
+        else if (strcmp(argv[i], "--replay") == 0) {
+            while (i + 1 < argc && strncmp(argv[i + 1], "--", 2) != 0) {
+                replayPaths.push_back(argv[++i]);
+            }
+        }
+        else if (strcmp(argv[i], "--capture") == 0 && i + 2 < argc) {
+            captureReplay = argv[++i];
+            captureDir = argv[++i];
+        }
+        else if (strcmp(argv[i], "--capture-format") == 0 && i + 1 < argc) {
+            captureFormat = strcmp(argv[++i], "png") == 0 ? FrameCapture::FORMAT_PNG : FrameCapture::FORMAT_RAW;
+        }
+        else if (strcmp(argv[i], "--ghosts") == 0) {
+            while (i + 1 < argc && strncmp(argv[i + 1], "--", 2) != 0) {
+                ghostPaths.push_back(argv[++i]);
+            }
+        }
+        else if (strcmp(argv[i], "--pipelined") == 0) {
+            pipelined = true;
+        }
+        else if (strcmp(argv[i], "--low-latency") == 0) {
+            lowLatency = true;
+        }
+        else if (strcmp(argv[i], "--fps") == 0 && i + 1 < argc) {
+            targetFps = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--profile") == 0 && i + 1 < argc) {
+            tracePath = argv[++i];
+            Profiler::instance().setEnabled(true);
+        }
+    }
+
+    if (captureReplay) {
+        return runCapture(captureReplay, captureDir, captureFormat);
+    }
+    if (!replayPaths.empty()) {
+        return runReplays(replayPaths);
+    }
+    if (batchMode) {
+        return runBatchMode(batchConfig);
+    }
+    if (!serverConfig.socketPath.empty()) {
+        return runEnvServer(serverConfig);
+    }
+
     Game game;
+    game.setScoreLog(Game::SCORE_LOG_PATH);
+    if (seedArg) {
+        game.setSeed(strtoull(seedArg, nullptr, 10));
+    }
+    // Без --seed игра идёт по трассе первого призрака, чтобы с ним можно было соревноваться
+    for (const auto& path : ghostPaths) {
+        Replay replay;
+        if (!replay.load(path) || !game.addGhost(replay)) {
+            continue;
+        }
+        if (!seedArg && game.getGhostCount() == 1) {
+            game.setSeed(replay.seed);
+        }
+    }
+    if (!ghostPaths.empty()) {
+        std::cout << "Ghosts: " << game.getGhostCount() << " of " << ghostPaths.size() << " replays" << std::endl;
+    }
+    if (recordPath) {
+        game.startRecording(recordPath);
+    }
+    game.setLowLatency(lowLatency, targetFps);
+    game.setPipelined(pipelined);
 
     if (!game.init()) {
         return 1;
     }
 
+    // Фиксированный шаг симуляции: частота кадров не влияет на скорость игры,
+    // а медленный кадр догоняется несколькими шагами подряд. Физика задана
+    // в единицах на шаг, поэтому частота шагов постоянна
+    const double tickSeconds = 1.0 / Simulation::TICKS_PER_SECOND;
+    const double maxFrameSeconds = 0.25;  // Защита от "спирали смерти" после долгих пауз
+    const Uint64 frequency = SDL_GetPerformanceFrequency();
+    Uint64 previous = SDL_GetPerformanceCounter();
+    double accumulator = 0.0;
+
+    // В конвейерном режиме кадры рисует отдельный поток, а этот цикл только опрашивает
+    // ввод и шагает симуляцию, поэтому present с vsync его не блокирует
+    if (pipelined && !game.startRenderThread(tickSeconds)) {
+        pipelined = false;
+    }
+
+    // Без vsync кадры отмеряет ограничитель. Ожидание идёт до опроса ввода,
+    // так что нажатие попадает в шаг симуляции и present того же кадра
+    FrameLimiter limiter(game.getTargetFps());
+
+    Profiler& profiler = Profiler::instance();
     while (game.isGameRunning()) {
+        // На неподвижном экране спим до события; время простоя не догоняется шагами
+        if (game.isIdle()) {
+            game.waitForEvent();
+            previous = SDL_GetPerformanceCounter();
+            accumulator = 0.0;
+        }
+
+        if (!pipelined) {
+            if (lowLatency) {
+                limiter.wait();
+            }
+            profiler.beginFrame();
+        }
+        const Uint64 now = SDL_GetPerformanceCounter();
+        accumulator += std::min(static_cast<double>(now - previous) / frequency, maxFrameSeconds);
+        previous = now;
+
         game.handleEvents();
-        game.update();
-        game.render();
+        while (accumulator >= tickSeconds) {
+            game.update();
+            accumulator -= tickSeconds;
+        }
+
+        if (pipelined) {
+            SDL_Delay(1);
+            continue;
+        }
+        game.render(static_cast<float>(accumulator / tickSeconds));
+        profiler.endFrame();
+    }
+    game.stopRenderThread();
+
+    if (tracePath) {
+        profiler.writeChromeTrace(tracePath);
     }
 
     game.clean();
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,126 @@
+#include <SDL.h>
+#include <SDL_image.h>
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include "AssetArchive.h"
+#include "AssetManifest.h"
+#include "TextureAtlas.h"
+
+// Упаковщик ресурсов: FlappyBird_packer <каталог assets> <файл .pak>
+// Картинки декодируются и уменьшаются так же, как при загрузке атласа,
+// WAV переводятся в формат микшера, остальное копируется как есть.
+
+static bool readFile(const std::string& path, std::vector<unsigned char>& data) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+    data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    return true;
+}
+
+static bool packSprite(AssetArchiveWriter& writer, const std::string& dir, const AssetManifest::Sprite& sprite) {
+    const std::string path = dir + "/" + sprite.path;
+    SDL_Surface* loaded = IMG_Load(path.c_str());
+    if (!loaded) {
+        std::cout << "Failed to load image " << path << ": " << IMG_GetError() << std::endl;
+        return false;
+    }
+    SDL_Surface* prepared = TextureAtlas::prepare(loaded, sprite.maxWidth, sprite.maxHeight);
+    SDL_FreeSurface(loaded);
+    if (!prepared) {
+        return false;
+    }
+
+    SDL_LockSurface(prepared);
+    writer.addImage(sprite.name, prepared->format->format, prepared->w, prepared->h,
+                    prepared->pixels, prepared->pitch, prepared->format->BytesPerPixel);
+    SDL_UnlockSurface(prepared);
+    std::cout << "  " << sprite.name << ": " << prepared->w << "x" << prepared->h << std::endl;
+    SDL_FreeSurface(prepared);
+    return true;
+}
+
+static bool packSound(AssetArchiveWriter& writer, const std::string& dir, const AssetManifest::Sound& sound) {
+    const std::string path = dir + "/" + sound.path;
+    SDL_AudioSpec spec;
+    Uint8* buffer = nullptr;
+    Uint32 length = 0;
+    if (!SDL_LoadWAV(path.c_str(), &spec, &buffer, &length)) {
+        std::cout << "Failed to load sound " << path << ": " << SDL_GetError() << std::endl;
+        return false;
+    }
+
+    SDL_AudioCVT cvt;
+    if (SDL_BuildAudioCVT(&cvt, spec.format, spec.channels, spec.freq, AssetManifest::AUDIO_SAMPLE_FORMAT,
+                          AssetManifest::AUDIO_CHANNELS, AssetManifest::AUDIO_FREQUENCY) < 0) {
+        std::cout << "Unsupported audio format in " << path << ": " << SDL_GetError() << std::endl;
+        SDL_FreeWAV(buffer);
+        return false;
+    }
+    std::vector<Uint8> samples(static_cast<size_t>(length) * std::max(cvt.len_mult, 1));
+    memcpy(samples.data(), buffer, length);
+    SDL_FreeWAV(buffer);
+    cvt.buf = samples.data();
+    cvt.len = static_cast<int>(length);
+    if (cvt.needed && SDL_ConvertAudio(&cvt) < 0) {
+        std::cout << "Failed to convert " << path << ": " << SDL_GetError() << std::endl;
+        return false;
+    }
+    const size_t size = cvt.needed ? static_cast<size_t>(cvt.len_cvt) : length;
+
+    writer.addSound(sound.name, AssetManifest::AUDIO_SAMPLE_FORMAT, AssetManifest::AUDIO_FREQUENCY,
+                    AssetManifest::AUDIO_CHANNELS, samples.data(), size);
+    std::cout << "  " << sound.name << ": " << size << " bytes PCM" << std::endl;
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        std::cout << "Usage: " << argv[0] << " <assets dir> <output.pak>" << std::endl;
+        return 1;
+    }
+    const std::string dir = argv[1];
+    const std::string output = argv[2];
+
+    if (SDL_Init(0) < 0 || !(IMG_Init(IMG_INIT_PNG) & IMG_INIT_PNG)) {
+        std::cout << "SDL initialization failed: " << SDL_GetError() << std::endl;
+        return 1;
+    }
+
+    AssetArchiveWriter writer;
+    bool ok = true;
+    for (const auto& sprite : AssetManifest::SPRITES) {
+        ok = packSprite(writer, dir, sprite) && ok;
+    }
+    for (const auto& sound : AssetManifest::SOUNDS) {
+        ok = packSound(writer, dir, sound) && ok;
+    }
+
+    std::vector<unsigned char> data;
+    if (readFile(dir + "/" + AssetManifest::FONT_PATH, data)) {
+        writer.addBlob(AssetManifest::FONT_PATH, data.data(), data.size());
+    }
+    else {
+        std::cout << "Failed to read font " << AssetManifest::FONT_PATH << std::endl;
+        ok = false;
+    }
+    // Фоновая музыка необязательна
+    if (readFile(dir + "/" + AssetManifest::MUSIC_PATH, data)) {
+        writer.addBlob(AssetManifest::MUSIC_PATH, data.data(), data.size());
+    }
+
+    ok = ok && writer.save(output);
+    if (ok) {
+        std::cout << "Packed " << output << std::endl;
+    }
+
+    IMG_Quit();
+    SDL_Quit();
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,85 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include "EnvProtocol.h"
+#include "LocalSocket.h"
+#include "MappedFile.h"
+
+// Локальный клиент сервера сред: FlappyBird_env_client <сокет> [шагов] [seed]
+// Подключается к FlappyBird --serve, играет во всех средах простой политикой
+// по наблюдениям из общей памяти и печатает скорость и средний счёт.
+// Пример того, что делает клиент на Python: действия и наблюдения не копируются
+// через сокет, по нему идут только запросы по 16 байт.
+
+static bool call(LocalSocket& socket, uint32_t command, uint64_t seed, EnvProtocol::Reply& reply) {
+    const EnvProtocol::Request request = {command, 0, seed};
+    return socket.sendAll(&request, sizeof(request)) && socket.receiveAll(&reply, sizeof(reply)) &&
+           reply.status == EnvProtocol::STATUS_OK;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cout << "Usage: FlappyBird_env_client <socket> [steps] [seed]" << std::endl;
+        return 1;
+    }
+    const std::string socketPath = argv[1];
+    const long long steps = argc > 2 ? atoll(argv[2]) : 10000;
+    const uint64_t seed = argc > 3 ? strtoull(argv[3], nullptr, 10) : 1;
+
+    LocalSocket socket;
+    MappedFile shared;
+    if (!socket.connect(socketPath) || !shared.open(socketPath + ".shm")) {
+        return 1;
+    }
+    const auto* header = static_cast<const EnvProtocol::Header*>(shared.data());
+    if (shared.size() < sizeof(EnvProtocol::Header) || memcmp(header->magic, "FBEV", 4) != 0 ||
+        header->version != EnvProtocol::VERSION || header->totalBytes > shared.size()) {
+        std::cout << "Unsupported shared memory layout" << std::endl;
+        return 1;
+    }
+    uint8_t* base = static_cast<uint8_t*>(shared.data());
+    uint8_t* actions = base + header->actionsOffset;
+    std::cout << "Connected: " << header->envCount << " environments, frames "
+              << header->frameWidth << "x" << header->frameHeight << " x" << header->frameStack << std::endl;
+
+    EnvProtocol::Reply reply;
+    if (!call(socket, EnvProtocol::COMMAND_RESET, seed, reply)) {
+        return 1;
+    }
+
+    long long episodes = 0;
+    long long totalScore = 0;
+    int bestScore = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (long long i = 0; i < steps; i++) {
+        // Политика: взмах, если птица ниже середины ближайшего зазора и падает
+        const uint8_t* slot = base + header->slotsOffset + reply.slot * header->slotBytes;
+        const auto* observations =
+            reinterpret_cast<const EnvProtocol::Observation*>(slot + sizeof(EnvProtocol::SlotHeader));
+        for (uint32_t env = 0; env < header->envCount; env++) {
+            const EnvProtocol::Observation& obs = observations[env];
+            if (obs.terminated || obs.truncated) {
+                episodes++;
+                totalScore += obs.score;
+                bestScore = std::max(bestScore, static_cast<int>(obs.score));
+            }
+            const float target = (obs.gapTop + obs.gapBottom) / 2;
+            actions[env] = obs.birdY + 15 > target && obs.birdVelocity >= 0;
+        }
+        if (!call(socket, EnvProtocol::COMMAND_STEP, 0, reply)) {
+            std::cout << "Step failed" << std::endl;
+            return 1;
+        }
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << steps << " steps in " << seconds << " s: " << static_cast<long long>(steps / seconds)
+              << " steps/s, " << static_cast<long long>(steps * header->envCount / seconds)
+              << " env steps/s" << std::endl;
+    std::cout << "Episodes: " << episodes << ", mean score "
+              << (episodes ? static_cast<double>(totalScore) / episodes : 0.0) << ", best " << bestScore << std::endl;
+    return 0;
+}